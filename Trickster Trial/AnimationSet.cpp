@@ -0,0 +1,87 @@
+#include "AnimationSet.h"
+#include "TextureAtlas.h"
+#include "AssetArchive.h"
+#include <iostream>
+#include <map>
+
+const AnimationClip AnimationSet::s_emptyClip;
+
+std::shared_ptr<const AnimationSet> AnimationSet::LoadFiles(const std::string& folder,
+    int frameWidth, int frameHeight,
+    const std::vector<std::pair<int, std::string>>& files, int atlasGroup)
+{
+    // Weak entries: a set lives as long as some instance uses it. Keyed
+    // by group too, so loading a folder for a second group goes through
+    // AddSheet() again (which moves shared sheets to COMMON_GROUP).
+    struct LoadedSet
+    {
+        std::weak_ptr<const AnimationSet>        set;
+        std::vector<std::pair<int, std::string>> files;
+    };
+    static std::map<std::pair<std::string, int>, LoadedSet> loaded;
+
+    const std::pair<std::string, int> key(folder, atlasGroup);
+    auto found = loaded.find(key);
+    if (found != loaded.end() && found->second.files == files)
+    {
+        std::shared_ptr<const AnimationSet> existing = found->second.set.lock();
+        if (existing && existing->m_frameWidth == frameWidth && existing->m_frameHeight == frameHeight)
+            return existing;
+    }
+
+    if (frameWidth <= 0 || frameHeight <= 0)
+        return nullptr;
+
+    std::shared_ptr<AnimationSet> set = std::make_shared<AnimationSet>();
+    set->m_frameWidth = frameWidth;
+    set->m_frameHeight = frameHeight;
+
+    for (const auto& file : files)
+    {
+        std::string fullPath = folder + "/" + file.second;
+
+        // Only the sheet size is read here; pixels are packed by TextureAtlas::Build
+        int texW = 0, texH = 0;
+        int sprite = TextureAtlas::Instance().AddSheet(fullPath, texW, texH, atlasGroup);
+        if (sprite < 0)
+        {
+            std::cout << "Failed to load animation sheet: " << fullPath << "\n";
+            return nullptr;
+        }
+
+        if (file.first >= static_cast<int>(set->m_clips.size()))
+            set->m_clips.resize(file.first + 1);
+
+        // Packed sheets carry their frame layout (checked by the packer)
+        int clipFrameW = frameWidth;
+        int clipFrameH = frameHeight;
+        int clipFrameCount = texW / frameWidth;
+
+        const AssetArchive::Entry* packed = AssetArchive::Instance().Find(fullPath);
+        if (packed && packed->kind == AssetArchive::EntryKind::Image && packed->frameCount > 0)
+        {
+            clipFrameW = packed->frameWidth;
+            clipFrameH = packed->frameHeight;
+            clipFrameCount = packed->frameCount;
+
+            if (clipFrameW != frameWidth || clipFrameH != frameHeight)
+                std::cout << "Frame size of " << fullPath << " is " << clipFrameW << "x" << clipFrameH
+                    << " in the archive, expected " << frameWidth << "x" << frameHeight << "\n";
+        }
+
+        AnimationClip& clip = set->m_clips[file.first];
+        clip.sprite = sprite;
+        clip.frameCount = clipFrameCount;
+
+        clip.frames.clear();
+        for (int i = 0; i < clip.frameCount; ++i)
+            clip.frames.push_back(SDL_Rect{ i * clipFrameW, 0, clipFrameW, clipFrameH });
+
+        std::cout << "Loaded " << fullPath << " with " << clip.frameCount << " frames\n";
+    }
+
+    LoadedSet& entry = loaded[key];
+    entry.set = set;
+    entry.files = files;
+    return set;
+}
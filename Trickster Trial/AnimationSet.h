@@ -0,0 +1,65 @@
+#pragma once
+
+#include <SDL.h>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "TextureAtlas.h"
+
+// One clip = one sprite sheet cut into equal frames (left to right)
+struct AnimationClip
+{
+    int sprite = -1;                // TextureAtlas id
+    int frameCount = 0;
+    std::vector<SDL_Rect> frames;   // source rect per frame, relative to the sheet
+};
+
+// Immutable clip table for one archetype (player, king pig, pig, door,
+// dialogue), indexed by that archetype's state enum. Every instance
+// shares the same set; instances only keep their state + frame.
+class AnimationSet
+{
+public:
+    // Sheets are folder + "/" + file name, registered in the given
+    // TextureAtlas residency group. Frames are cut using the layout
+    // stored in the asset archive; frameWidth/frameHeight are for loose
+    // files and sheets without one. Loading the same folder, clips and
+    // group again returns the set that is already loaded. nullptr on
+    // failure.
+    template <typename State>
+    static std::shared_ptr<const AnimationSet> Load(const std::string& folder,
+        int frameWidth, int frameHeight,
+        std::initializer_list<std::pair<State, const char*>> clips,
+        int atlasGroup = TextureAtlas::COMMON_GROUP)
+    {
+        std::vector<std::pair<int, std::string>> files;
+        for (const auto& clip : clips)
+            files.emplace_back(static_cast<int>(clip.first), clip.second);
+
+        return LoadFiles(folder, frameWidth, frameHeight, files, atlasGroup);
+    }
+
+    // States without a sheet get an empty clip (frameCount 0)
+    template <typename State>
+    const AnimationClip& GetClip(State state) const
+    {
+        size_t index = static_cast<size_t>(state);
+        return index < m_clips.size() ? m_clips[index] : s_emptyClip;
+    }
+
+    int GetFrameWidth()  const { return m_frameWidth; }
+    int GetFrameHeight() const { return m_frameHeight; }
+
+private:
+    static std::shared_ptr<const AnimationSet> LoadFiles(const std::string& folder,
+        int frameWidth, int frameHeight,
+        const std::vector<std::pair<int, std::string>>& files, int atlasGroup);
+
+    static const AnimationClip s_emptyClip;
+
+    int m_frameWidth = 0;
+    int m_frameHeight = 0;
+    std::vector<AnimationClip> m_clips;
+};
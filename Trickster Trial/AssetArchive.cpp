@@ -0,0 +1,418 @@
+#include "AssetArchive.h"
+#include "ByteIO.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const char* AssetArchive::DEFAULT_PATH = "assets.pak";
+
+namespace
+{
+    const char   MAGIC[4] = { 'T', 'T', 'P', 'K' };
+    const Uint32 VERSION = 1;
+    const size_t HEADER_SIZE = 16;
+    const size_t ENTRY_FIXED_SIZE = 7 * 4 + 2 * 8 + 4; // fields before the path
+    const size_t DATA_ALIGN = 16;
+
+    // All files below 'folder', as "folder/sub/name" with forward slashes
+    void ListFiles(const std::string& folder, std::vector<std::string>& outPaths)
+    {
+#ifdef _WIN32
+        WIN32_FIND_DATAA found;
+        HANDLE find = FindFirstFileA((folder + "/*").c_str(), &found);
+        if (find == INVALID_HANDLE_VALUE)
+            return;
+
+        do
+        {
+            std::string name = found.cFileName;
+            if (name == "." || name == "..")
+                continue;
+
+            if (found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+                ListFiles(folder + "/" + name, outPaths);
+            else
+                outPaths.push_back(folder + "/" + name);
+        } while (FindNextFileA(find, &found));
+
+        FindClose(find);
+#else
+        DIR* dir = opendir(folder.c_str());
+        if (!dir)
+            return;
+
+        while (dirent* item = readdir(dir))
+        {
+            std::string name = item->d_name;
+            if (name == "." || name == "..")
+                continue;
+
+            std::string path = folder + "/" + name;
+            struct stat info;
+            if (stat(path.c_str(), &info) != 0)
+                continue;
+
+            if (S_ISDIR(info.st_mode))
+                ListFiles(path, outPaths);
+            else
+                outPaths.push_back(path);
+        }
+
+        closedir(dir);
+#endif
+    }
+
+    bool EndsWith(const std::string& text, const std::string& suffix)
+    {
+        if (text.size() < suffix.size())
+            return false;
+
+        for (size_t i = 0; i < suffix.size(); ++i)
+        {
+            char c = text[text.size() - suffix.size() + i];
+            if (c >= 'A' && c <= 'Z')
+                c = static_cast<char>(c - 'A' + 'a');
+            if (c != suffix[i])
+                return false;
+        }
+        return true;
+    }
+
+    // Sheets are named like "Run (78x58).png"
+    void ParseFrameSize(const std::string& path, int& outW, int& outH)
+    {
+        outW = 0;
+        outH = 0;
+
+        size_t open = path.rfind('(');
+        if (open == std::string::npos)
+            return;
+
+        int w = 0, h = 0;
+        if (std::sscanf(path.c_str() + open, "(%dx%d)", &w, &h) == 2 && w > 0 && h > 0)
+        {
+            outW = w;
+            outH = h;
+        }
+    }
+
+    // Only what the game loads; editor leftovers next to the levels
+    // (*.journal sidecars, *.tmp from an interrupted save) stay out
+    bool IsPackable(const std::string& path)
+    {
+        return EndsWith(path, ".png") || EndsWith(path, ".lvl") || EndsWith(path, ".map") ||
+            EndsWith(path, ".txt") || EndsWith(path, ".tiles");
+    }
+
+    struct PackedItem
+    {
+        std::string        path;
+        AssetArchive::Entry entry;
+        std::vector<Uint8> bytes;
+    };
+}
+
+AssetArchive::~AssetArchive()
+{
+    Close();
+}
+
+bool AssetArchive::Open(const std::string& path)
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file); // the mapping keeps the file open
+    if (!mapping)
+        return false;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_mappingHandle = mapping;
+    m_base = static_cast<const Uint8*>(view);
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file open
+    if (view == MAP_FAILED)
+        return false;
+
+    m_base = static_cast<const Uint8*>(view);
+    m_size = static_cast<size_t>(info.st_size);
+#endif
+
+    // Header
+    if (m_size < HEADER_SIZE || std::memcmp(m_base, MAGIC, sizeof(MAGIC)) != 0 ||
+        ReadU32(m_base + 4) != VERSION)
+    {
+        SDL_Log("AssetArchive: %s is not a version %u archive", path.c_str(), VERSION);
+        Close();
+        return false;
+    }
+
+    if (ReadU32(m_base + 8) != SDL_PIXELFORMAT_RGBA32)
+    {
+        SDL_Log("AssetArchive: %s was packed for another byte order", path.c_str());
+        Close();
+        return false;
+    }
+
+    Uint32 count = ReadU32(m_base + 12);
+    size_t pos = HEADER_SIZE;
+
+    // Index (every offset checked against the file size)
+    for (Uint32 i = 0; i < count; ++i)
+    {
+        if (pos + ENTRY_FIXED_SIZE > m_size)
+            break;
+
+        const Uint8* p = m_base + pos;
+
+        Entry entry;
+        entry.kind = static_cast<EntryKind>(ReadU32(p + 0));
+        entry.width = static_cast<int>(ReadU32(p + 4));
+        entry.height = static_cast<int>(ReadU32(p + 8));
+        entry.pitch = static_cast<int>(ReadU32(p + 12));
+        entry.frameWidth = static_cast<int>(ReadU32(p + 16));
+        entry.frameHeight = static_cast<int>(ReadU32(p + 20));
+        entry.frameCount = static_cast<int>(ReadU32(p + 24));
+        Uint64 offset = ReadU64(p + 28);
+        Uint64 size = ReadU64(p + 36);
+        Uint32 pathLength = ReadU32(p + 44);
+
+        pos += ENTRY_FIXED_SIZE;
+        if (pos + pathLength > m_size || offset > m_size || size > m_size - offset)
+            break;
+
+        if (entry.kind == EntryKind::Image &&
+            static_cast<Uint64>(entry.pitch) * static_cast<Uint64>(entry.height) > size)
+            break;
+
+        std::string entryPath(reinterpret_cast<const char*>(m_base + pos), pathLength);
+        pos += pathLength;
+
+        entry.data = m_base + offset;
+        entry.size = static_cast<size_t>(size);
+        m_entries[entryPath] = entry;
+    }
+
+    if (m_entries.size() != count)
+    {
+        SDL_Log("AssetArchive: %s is truncated or corrupt", path.c_str());
+        Close();
+        return false;
+    }
+
+    std::cout << "Asset archive " << path << ": " << count << " entries\n";
+    return true;
+}
+
+void AssetArchive::Close()
+{
+    m_entries.clear();
+
+    if (!m_base)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_base);
+    CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+    m_mappingHandle = nullptr;
+#else
+    munmap(const_cast<Uint8*>(m_base), m_size);
+#endif
+
+    m_base = nullptr;
+    m_size = 0;
+}
+
+const AssetArchive::Entry* AssetArchive::Find(const std::string& path) const
+{
+    auto it = m_entries.find(path);
+    return it != m_entries.end() ? &it->second : nullptr;
+}
+
+bool AssetArchive::Pack(const std::vector<std::string>& folders, const std::string& outPath)
+{
+    std::vector<std::string> paths;
+    for (const std::string& folder : folders)
+        ListFiles(folder, paths);
+
+    paths.erase(std::remove_if(paths.begin(), paths.end(),
+        [](const std::string& path) { return !IsPackable(path); }), paths.end());
+
+    // Same input = byte-identical archive
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<PackedItem> items;
+    items.reserve(paths.size());
+
+    for (const std::string& path : paths)
+    {
+        PackedItem item;
+        item.path = path;
+
+        if (EndsWith(path, ".png"))
+        {
+            SDL_Surface* image = IMG_Load(path.c_str());
+            SDL_Surface* rgba = image ? SDL_ConvertSurfaceFormat(image, SDL_PIXELFORMAT_RGBA32, 0) : nullptr;
+            if (image)
+                SDL_FreeSurface(image);
+
+            if (!rgba)
+            {
+                std::cout << "Pack: failed to decode " << path << ": " << IMG_GetError() << "\n";
+                return false;
+            }
+
+            Entry& entry = item.entry;
+            entry.kind = EntryKind::Image;
+            entry.width = rgba->w;
+            entry.height = rgba->h;
+            entry.pitch = rgba->w * 4;  // rows stored tightly
+            ParseFrameSize(path, entry.frameWidth, entry.frameHeight);
+
+            // Some names don't describe the sheet (the dialogue boxes say
+            // 24x8 on 34x16 frames): only keep a layout that fits exactly
+            if (entry.frameWidth > 0 && (entry.width % entry.frameWidth != 0 || entry.frameHeight != entry.height))
+            {
+                entry.frameWidth = 0;
+                entry.frameHeight = 0;
+            }
+            entry.frameCount = entry.frameWidth > 0 ? entry.width / entry.frameWidth : 0;
+
+            item.bytes.resize(static_cast<size_t>(entry.pitch) * entry.height);
+
+            SDL_LockSurface(rgba);
+            for (int row = 0; row < rgba->h; ++row)
+            {
+                const Uint8* src = static_cast<const Uint8*>(rgba->pixels) + row * rgba->pitch;
+                std::memcpy(item.bytes.data() + static_cast<size_t>(row) * entry.pitch, src, entry.pitch);
+            }
+            SDL_UnlockSurface(rgba);
+            SDL_FreeSurface(rgba);
+        }
+        else
+        {
+            std::ifstream in(path, std::ios::binary);
+            if (!in)
+            {
+                std::cout << "Pack: failed to read " << path << "\n";
+                return false;
+            }
+
+            item.entry.kind = EntryKind::File;
+            item.bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+
+        items.push_back(std::move(item));
+    }
+
+    // Index size first, so data offsets are known while writing it
+    size_t indexEnd = HEADER_SIZE;
+    for (const PackedItem& item : items)
+        indexEnd += ENTRY_FIXED_SIZE + item.path.size();
+
+    std::vector<Uint8> header;
+    header.insert(header.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    AppendU32(header, VERSION);
+    AppendU32(header, SDL_PIXELFORMAT_RGBA32);
+    AppendU32(header, static_cast<Uint32>(items.size()));
+
+    std::vector<size_t> offsets;
+    size_t dataPos = indexEnd;
+    for (const PackedItem& item : items)
+    {
+        dataPos = (dataPos + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN;
+        offsets.push_back(dataPos);
+        dataPos += item.bytes.size();
+    }
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        const Entry& entry = items[i].entry;
+        AppendU32(header, static_cast<Uint32>(entry.kind));
+        AppendU32(header, static_cast<Uint32>(entry.width));
+        AppendU32(header, static_cast<Uint32>(entry.height));
+        AppendU32(header, static_cast<Uint32>(entry.pitch));
+        AppendU32(header, static_cast<Uint32>(entry.frameWidth));
+        AppendU32(header, static_cast<Uint32>(entry.frameHeight));
+        AppendU32(header, static_cast<Uint32>(entry.frameCount));
+        AppendU64(header, offsets[i]);
+        AppendU64(header, items[i].bytes.size());
+        AppendU32(header, static_cast<Uint32>(items[i].path.size()));
+        header.insert(header.end(), items[i].path.begin(), items[i].path.end());
+    }
+
+    std::ofstream out(outPath, std::ios::binary);
+    if (!out)
+    {
+        std::cout << "Pack: failed to open " << outPath << " for writing\n";
+        return false;
+    }
+
+    out.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+    size_t written = header.size();
+    const char padding[DATA_ALIGN] = {};
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        out.write(padding, offsets[i] - written);
+        out.write(reinterpret_cast<const char*>(items[i].bytes.data()), items[i].bytes.size());
+        written = offsets[i] + items[i].bytes.size();
+    }
+
+    if (!out)
+    {
+        std::cout << "Pack: write to " << outPath << " failed\n";
+        return false;
+    }
+
+    std::cout << "Packed " << items.size() << " assets into " << outPath
+        << " (" << written / 1024 << " KB)\n";
+    return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <SDL.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// One packed file holding every asset: images already decoded to
+// RGBA32 pixels plus raw files (levels), behind a single index.
+// Built offline (--pack-assets), opened read-only as a memory
+// mapping at startup; lookups hand out pointers into the mapping.
+//
+// Layout (little endian):
+//   header  "TTPK", version, pixel format, entry count
+//   index   per entry: kind, width, height, pitch, frame w/h, frame
+//           count, data offset, data size, path length, path
+//   data    one blob per entry, 16-byte aligned
+class AssetArchive
+{
+public:
+    static AssetArchive& Instance()
+    {
+        static AssetArchive instance;
+        return instance;
+    }
+
+    static const char* DEFAULT_PATH;
+
+    enum class EntryKind : Uint32
+    {
+        Image = 1,  // RGBA32 pixels, 'pitch' bytes per row
+        File = 2    // bytes exactly as on disk
+    };
+
+    struct Entry
+    {
+        EntryKind    kind = EntryKind::File;
+        int          width = 0;
+        int          height = 0;
+        int          pitch = 0;
+        int          frameWidth = 0;  // from "(WxH)" in the file name when it fits the sheet, 0 = none
+        int          frameHeight = 0;
+        int          frameCount = 0;
+        const Uint8* data = nullptr;  // points into the mapping
+        size_t       size = 0;
+    };
+
+    ~AssetArchive();
+
+    // false = no (valid) archive; callers fall back to loose files
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_base != nullptr; }
+
+    // nullptr if the path isn't packed (paths as used by the game,
+    // e.g. "assets/anim/Human/Idle (78x58).png")
+    const Entry* Find(const std::string& path) const;
+    int GetEntryCount() const { return static_cast<int>(m_entries.size()); }
+
+    // Offline packer: every file under 'folders' (recursively) into
+    // outPath. PNGs are decoded here so the game never has to.
+    static bool Pack(const std::vector<std::string>& folders, const std::string& outPath);
+
+private:
+    AssetArchive() = default;
+
+    const Uint8* m_base = nullptr;
+    size_t       m_size = 0;
+    void*        m_mappingHandle = nullptr; // Windows file mapping object
+
+    std::unordered_map<std::string, Entry> m_entries;
+};
@@ -0,0 +1,109 @@
+#include "AssetLoader.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <system_error>
+
+AssetLoader::~AssetLoader()
+{
+    Reset();
+}
+
+bool AssetLoader::Start(const std::vector<std::string>& paths, int workerCount)
+{
+    Reset();
+
+    m_paths = paths;
+    m_surfaces.assign(m_paths.size(), nullptr);
+    m_next = 0;
+    m_done = 0;
+
+    if (m_paths.empty())
+        return true;
+
+    if (workerCount <= 0)
+        workerCount = static_cast<int>(std::thread::hardware_concurrency());
+    workerCount = std::max(1, std::min({ workerCount, MAX_WORKERS, static_cast<int>(m_paths.size()) }));
+
+    for (int i = 0; i < workerCount; ++i)
+    {
+        try
+        {
+            m_workers.emplace_back(&AssetLoader::WorkerMain, this);
+        }
+        catch (const std::system_error&)
+        {
+            // Whatever started will still get through the whole list
+            SDL_Log("AssetLoader: could only start %d of %d workers", i, workerCount);
+            break;
+        }
+    }
+
+    if (m_workers.empty())
+    {
+        // No threads at all: decode right here
+        WorkerMain();
+    }
+
+    return true;
+}
+
+void AssetLoader::WorkerMain()
+{
+    const int count = static_cast<int>(m_paths.size());
+
+    for (int index = m_next++; index < count; index = m_next++)
+    {
+        SDL_Surface* image = IMG_Load(m_paths[index].c_str());
+        if (!image)
+            SDL_Log("Failed to load %s: %s", m_paths[index].c_str(), IMG_GetError());
+
+        m_surfaces[index] = image;
+        ++m_done;
+    }
+}
+
+void AssetLoader::Wait()
+{
+    for (std::thread& worker : m_workers)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+    m_workers.clear();
+}
+
+float AssetLoader::GetProgress() const
+{
+    if (m_paths.empty())
+        return 1.0f;
+
+    return static_cast<float>(m_done.load()) / static_cast<float>(m_paths.size());
+}
+
+SDL_Surface* AssetLoader::TakeSurface(int index)
+{
+    Wait();
+
+    if (index < 0 || index >= static_cast<int>(m_surfaces.size()))
+        return nullptr;
+
+    SDL_Surface* surface = m_surfaces[index];
+    m_surfaces[index] = nullptr;
+    return surface;
+}
+
+void AssetLoader::Reset()
+{
+    Wait();
+
+    for (SDL_Surface* surface : m_surfaces)
+    {
+        if (surface)
+            SDL_FreeSurface(surface);
+    }
+
+    m_surfaces.clear();
+    m_paths.clear();
+    m_next = 0;
+    m_done = 0;
+}
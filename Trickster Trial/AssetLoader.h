@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SDL.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Decodes image files into SDL_Surfaces on a few worker threads.
+// Only the decoding runs off the main thread: turning the surfaces
+// into textures stays with the caller (renderer calls are main-thread
+// only). Progress can be polled while the workers run.
+class AssetLoader
+{
+public:
+    AssetLoader() = default;
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Start decoding. workerCount 0 = one per core (at most MAX_WORKERS).
+    bool Start(const std::vector<std::string>& paths, int workerCount = 0);
+
+    // Block until every file is decoded
+    void Wait();
+
+    bool  IsDone() const { return m_done.load() >= static_cast<int>(m_paths.size()); }
+    int   GetDoneCount() const { return m_done.load(); }
+    int   GetTotalCount() const { return static_cast<int>(m_paths.size()); }
+    float GetProgress() const;
+
+    // Decoded image for paths[index], nullptr if it failed to load.
+    // Waits for the workers; the caller owns (and frees) the surface.
+    SDL_Surface* TakeSurface(int index);
+
+    // Free anything not taken and forget the file list
+    void Reset();
+
+    static const int MAX_WORKERS = 8;
+
+private:
+    void WorkerMain();
+
+    std::vector<std::string>  m_paths;
+    std::vector<SDL_Surface*> m_surfaces; // one slot per path, written by one worker each
+    std::vector<std::thread>  m_workers;
+
+    std::atomic<int> m_next{ 0 };  // next path to claim
+    std::atomic<int> m_done{ 0 };  // paths finished (loaded or failed)
+};
@@ -0,0 +1,352 @@
+#include "Benchmark.h"
+#include "LevelDesigner.h"
+#include "Camera.h"
+#include "Character.h"
+#include "Enemy.h"
+#include "GameClock.h"
+#include <SDL.h>
+#include <SDL_image.h>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    // Each benchmark runs for at least this long per repeat; best repeat wins
+    const double MIN_SECONDS = 0.2;
+    const int    REPEATS = 5;
+
+    const char* BENCH_LEVEL_PATH = "bench_level.tmp";
+    const char* BENCH_LEVEL_TEXT_PATH = "bench_level_text.tmp";
+
+    // "large" level: a long scrolling stage (400 x 100 cells)
+    const int LARGE_COLS = 400;
+    const int LARGE_ROWS = 100;
+
+    struct BenchResult
+    {
+        std::string name;
+        Uint64      iterations = 0;
+        double      nsPerOp = 0.0;
+        double      opsPerSec = 0.0;
+        double      itemsPerSec = 0.0; // cells, queries... (0 = n/a)
+    };
+
+    // Keeps results alive so the optimizer can't drop the work
+    volatile int g_sink = 0;
+
+    double Seconds(Uint64 counterTicks)
+    {
+        return static_cast<double>(counterTicks) / static_cast<double>(SDL_GetPerformanceFrequency());
+    }
+
+    // Calibrate a batch size, then time REPEATS batches and keep the fastest
+    template <typename Op>
+    BenchResult Run(const std::string& name, double itemsPerOp, Op op)
+    {
+        Uint64 batch = 1;
+        for (;;)
+        {
+            Uint64 start = SDL_GetPerformanceCounter();
+            for (Uint64 i = 0; i < batch; ++i)
+                op();
+            double elapsed = Seconds(SDL_GetPerformanceCounter() - start);
+
+            if (elapsed >= MIN_SECONDS / 4 || batch >= (1ull << 40))
+            {
+                if (elapsed > 0.0)
+                    batch = static_cast<Uint64>(batch * (MIN_SECONDS / elapsed)) + 1;
+                break;
+            }
+            batch *= 4;
+        }
+
+        double best = 0.0;
+        for (int r = 0; r < REPEATS; ++r)
+        {
+            Uint64 start = SDL_GetPerformanceCounter();
+            for (Uint64 i = 0; i < batch; ++i)
+                op();
+            double elapsed = Seconds(SDL_GetPerformanceCounter() - start);
+
+            if (r == 0 || elapsed < best)
+                best = elapsed;
+        }
+
+        BenchResult result;
+        result.name = name;
+        result.iterations = batch;
+        result.nsPerOp = best * 1e9 / static_cast<double>(batch);
+        result.opsPerSec = best > 0.0 ? batch / best : 0.0;
+        result.itemsPerSec = result.opsPerSec * itemsPerOp;
+        return result;
+    }
+
+    // Synthetic map: walkable floor everywhere, solid border,
+    // plus a sprinkle of solid blocks when 'obstacles' is set
+    void BuildSyntheticMap(LevelDesigner& level, bool obstacles)
+    {
+        level.ClearGrid();
+
+        Uint32 rng = 12345;
+        for (int row = 0; row < level.GetRows(); ++row)
+        {
+            for (int col = 0; col < level.GetCols(); ++col)
+            {
+                bool border = row == 0 || col == 0 ||
+                    row == level.GetRows() - 1 || col == level.GetCols() - 1;
+
+                rng = rng * 1664525u + 1013904223u;
+                bool block = obstacles && (rng >> 24) < 40; // ~15%
+
+                if (border || block)
+                    level.SetCell(col, row, true, 15, 0); // solid wall tile
+                else
+                    level.SetCell(col, row, true, 1, 7);  // walkable floor
+            }
+        }
+    }
+
+    void PrintResults(const std::vector<BenchResult>& results, const std::string& format)
+    {
+        if (format == "json")
+        {
+            std::printf("{\n  \"benchmarks\": [\n");
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                const BenchResult& r = results[i];
+                std::printf("    { \"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, "
+                    "\"ops_per_sec\": %.1f, \"items_per_sec\": %.1f }%s\n",
+                    r.name.c_str(), static_cast<unsigned long long>(r.iterations),
+                    r.nsPerOp, r.opsPerSec, r.itemsPerSec,
+                    (i + 1 < results.size()) ? "," : "");
+            }
+            std::printf("  ]\n}\n");
+        }
+        else if (format == "csv")
+        {
+            std::printf("name,iterations,ns_per_op,ops_per_sec,items_per_sec\n");
+            for (const BenchResult& r : results)
+            {
+                std::printf("%s,%llu,%.3f,%.1f,%.1f\n", r.name.c_str(),
+                    static_cast<unsigned long long>(r.iterations),
+                    r.nsPerOp, r.opsPerSec, r.itemsPerSec);
+            }
+        }
+        else
+        {
+            std::printf("%-34s %14s %14s %16s\n", "benchmark", "ns/op", "ops/s", "items/s");
+            for (const BenchResult& r : results)
+            {
+                std::printf("%-34s %14.2f %14.0f %16.0f\n", r.name.c_str(),
+                    r.nsPerOp, r.opsPerSec, r.itemsPerSec);
+            }
+        }
+    }
+}
+
+int RunBenchmarks(const std::string& filter, const std::string& format)
+{
+    if (SDL_Init(SDL_INIT_TIMER) != 0)
+    {
+        std::cout << "SDL_Init Error: " << SDL_GetError() << "\n";
+        return 1;
+    }
+    IMG_Init(IMG_INIT_PNG);
+
+    std::vector<BenchResult> results;
+    auto wanted = [&](const std::string& name)
+        {
+            return filter.empty() || name.find(filter) != std::string::npos;
+        };
+
+    GameClock clock;
+
+    // Never write benchmark maps over the real levels
+    LevelDesigner level;
+    level.autoSaveEnabled = false;
+    level.Init(nullptr);
+    level.Resize(LevelDesigner::DEFAULT_GRID_COLS, LevelDesigner::DEFAULT_GRID_ROWS);
+
+    // Tile queries
+
+    if (wanted("is_solid_cell/random"))
+    {
+        BuildSyntheticMap(level, true);
+
+        // Includes out-of-bounds lookups like the movement code does
+        std::vector<SDL_Point> queries(4096);
+        Uint32 rng = 99;
+        for (SDL_Point& q : queries)
+        {
+            rng = rng * 1664525u + 1013904223u;
+            q.x = static_cast<int>((rng >> 8) % (level.GetCols() + 2)) - 1;
+            q.y = static_cast<int>((rng >> 20) % (level.GetRows() + 2)) - 1;
+        }
+
+        results.push_back(Run("is_solid_cell/random", static_cast<double>(queries.size()), [&]()
+            {
+                int solid = 0;
+                for (const SDL_Point& q : queries)
+                    solid += level.IsSolidCell(q.x, q.y) ? 1 : 0;
+                g_sink += solid;
+            }));
+    }
+
+    // Movement with collision
+
+    const float startX = LevelDesigner::TILE_SIZE_SCREEN * 1.0f;
+    const float startY = LevelDesigner::TILE_SIZE_SCREEN * 2.0f;
+    const float maxX = LevelDesigner::TILE_SIZE_SCREEN * (level.GetCols() - 4.0f);
+
+    const bool mapVariants[] = { false, true };
+    for (bool obstacles : mapVariants)
+    {
+        const std::string suffix = obstacles ? "/obstacles" : "/open_floor";
+
+        if (wanted("character_move" + suffix))
+        {
+            BuildSyntheticMap(level, obstacles);
+
+            Character player;
+            player.Init(clock);
+            player.SetPosition(startX, startY);
+
+            results.push_back(Run("character_move" + suffix, 1.0, [&]()
+                {
+                    player.MoveWithCollision(1.5f, 0.75f, level);
+                    if (player.GetX() > maxX || player.GetY() > startY + 64.0f)
+                        player.SetPosition(startX, startY);
+                }));
+        }
+
+        if (wanted("enemy_move" + suffix))
+        {
+            BuildSyntheticMap(level, obstacles);
+
+            Enemy pig;
+            pig.InitPig(clock, "assets/anim/Pig");
+            pig.SetPosition(startX, startY);
+
+            results.push_back(Run("enemy_move" + suffix, 1.0, [&]()
+                {
+                    pig.MoveWithCollision(1.5f, 0.75f, level);
+                    if (pig.GetX() > maxX || pig.GetY() > startY + 64.0f)
+                        pig.SetPosition(startX, startY);
+                }));
+        }
+    }
+
+    // Level file I/O
+
+    const bool largeVariants[] = { false, true };
+    for (bool large : largeVariants)
+    {
+        const std::string suffix = large ? "/large" : "/small";
+        if (!wanted("level_save" + suffix) && !wanted("level_load" + suffix) &&
+            !wanted("level_load_text" + suffix))
+            continue;
+
+        if (large)
+            level.Resize(LARGE_COLS, LARGE_ROWS);
+        else
+            level.Resize(LevelDesigner::DEFAULT_GRID_COLS, LevelDesigner::DEFAULT_GRID_ROWS);
+
+        BuildSyntheticMap(level, true);
+        level.SaveToFile(BENCH_LEVEL_PATH);
+
+        const double cellCount = static_cast<double>(level.GetRows() * level.GetCols());
+
+        if (wanted("level_save" + suffix))
+        {
+            results.push_back(Run("level_save" + suffix, cellCount, [&]()
+                {
+                    g_sink += level.SaveToFile(BENCH_LEVEL_PATH) ? 1 : 0;
+                }));
+        }
+
+        if (wanted("level_load" + suffix))
+        {
+            results.push_back(Run("level_load" + suffix, cellCount, [&]()
+                {
+                    g_sink += level.LoadFromFile(BENCH_LEVEL_PATH) ? 1 : 0;
+                }));
+        }
+
+        // Old text format, for comparison
+        if (wanted("level_load_text" + suffix))
+        {
+            level.ExportText(BENCH_LEVEL_TEXT_PATH);
+            results.push_back(Run("level_load_text" + suffix, cellCount, [&]()
+                {
+                    g_sink += level.LoadFromFile(BENCH_LEVEL_TEXT_PATH) ? 1 : 0;
+                }));
+            std::remove(BENCH_LEVEL_TEXT_PATH);
+        }
+
+        std::remove(BENCH_LEVEL_PATH);
+    }
+
+    // Tile rendering into an offscreen software renderer
+
+    // software = one-screen level, large_view = one screen scrolled into
+    // the middle of the large level (cost should match, not grow)
+    if (wanted("level_render/software") || wanted("level_render/large_view"))
+    {
+        SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 1280, 720, 32, SDL_PIXELFORMAT_ARGB8888);
+        SDL_Renderer* software = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+
+        if (software)
+        {
+            LevelDesigner renderLevel;
+            renderLevel.autoSaveEnabled = false;
+
+            if (renderLevel.Init(software))
+            {
+                Camera camera;
+                camera.SetViewSize(1280, 720);
+                const double visibleCells = static_cast<double>(LevelDesigner::DEFAULT_GRID_COLS * LevelDesigner::DEFAULT_GRID_ROWS);
+
+                if (wanted("level_render/software"))
+                {
+                    renderLevel.Resize(LevelDesigner::DEFAULT_GRID_COLS, LevelDesigner::DEFAULT_GRID_ROWS);
+                    BuildSyntheticMap(renderLevel, true);
+                    camera.SetWorldSize(renderLevel.GetWorldWidth(), renderLevel.GetWorldHeight());
+
+                    results.push_back(Run("level_render/software", visibleCells, [&]()
+                        {
+                            renderLevel.Render(software, renderLevel.GetActiveLevelRef(), camera);
+                        }));
+                }
+
+                if (wanted("level_render/large_view"))
+                {
+                    renderLevel.Resize(LARGE_COLS, LARGE_ROWS);
+                    BuildSyntheticMap(renderLevel, true);
+                    camera.SetWorldSize(renderLevel.GetWorldWidth(), renderLevel.GetWorldHeight());
+                    camera.CenterOn(renderLevel.GetWorldWidth() * 0.5f, renderLevel.GetWorldHeight() * 0.5f);
+
+                    results.push_back(Run("level_render/large_view", visibleCells, [&]()
+                        {
+                            renderLevel.Render(software, renderLevel.GetActiveLevelRef(), camera);
+                        }));
+                }
+            }
+
+            SDL_DestroyRenderer(software);
+        }
+        else
+        {
+            std::cout << "level_render skipped: " << SDL_GetError() << "\n";
+        }
+
+        if (target)
+            SDL_FreeSurface(target);
+    }
+
+    PrintResults(results, format);
+
+    IMG_Quit();
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <string>
+
+// Microbenchmarks for the hot paths (run with --bench).
+//   filter: only run benchmarks whose name contains this text ("" = all)
+//   format: "text" (table), "csv" or "json"
+// Returns the process exit code.
+int RunBenchmarks(const std::string& filter, const std::string& format);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <SDL.h>
+#include <cstring>
+#include <vector>
+
+// Little-endian fields of the binary files (replays, asset archive,
+// levels, edit journals). Pointers don't need to be aligned.
+
+inline Uint16 ReadU16(const Uint8* p)
+{
+    Uint16 v;
+    std::memcpy(&v, p, sizeof(v));
+    return SDL_SwapLE16(v);
+}
+
+inline Uint32 ReadU32(const Uint8* p)
+{
+    Uint32 v;
+    std::memcpy(&v, p, sizeof(v));
+    return SDL_SwapLE32(v);
+}
+
+inline Uint64 ReadU64(const Uint8* p)
+{
+    Uint64 v;
+    std::memcpy(&v, p, sizeof(v));
+    return SDL_SwapLE64(v);
+}
+
+inline void WriteU16(Uint8* p, Uint16 v)
+{
+    v = SDL_SwapLE16(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+inline void WriteU32(Uint8* p, Uint32 v)
+{
+    v = SDL_SwapLE32(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+inline void WriteU64(Uint8* p, Uint64 v)
+{
+    v = SDL_SwapLE64(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+// Add to the end of a buffer being built
+inline void AppendU32(std::vector<Uint8>& out, Uint32 v)
+{
+    out.resize(out.size() + sizeof(v));
+    WriteU32(out.data() + out.size() - sizeof(v), v);
+}
+
+inline void AppendU64(std::vector<Uint8>& out, Uint64 v)
+{
+    out.resize(out.size() + sizeof(v));
+    WriteU64(out.data() + out.size() - sizeof(v), v);
+}
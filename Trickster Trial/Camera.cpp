@@ -0,0 +1,38 @@
+#include "Camera.h"
+#include <cmath>
+
+void Camera::SetViewSize(int w, int h)
+{
+    m_view.w = w;
+    m_view.h = h;
+    Clamp();
+}
+
+void Camera::SetWorldSize(int w, int h)
+{
+    m_worldW = w;
+    m_worldH = h;
+    Clamp();
+}
+
+void Camera::CenterOn(float worldX, float worldY)
+{
+    m_view.x = static_cast<int>(std::floor(worldX - m_view.w * 0.5f));
+    m_view.y = static_cast<int>(std::floor(worldY - m_view.h * 0.5f));
+    Clamp();
+}
+
+SDL_Point Camera::ScreenToWorld(int screenX, int screenY) const
+{
+    return SDL_Point{ screenX + m_view.x, screenY + m_view.y };
+}
+
+void Camera::Clamp()
+{
+    // Levels smaller than the screen stay pinned to the top-left
+    // corner, like before the camera existed
+    if (m_view.x > m_worldW - m_view.w) m_view.x = m_worldW - m_view.w;
+    if (m_view.y > m_worldH - m_view.h) m_view.y = m_worldH - m_view.h;
+    if (m_view.x < 0) m_view.x = 0;
+    if (m_view.y < 0) m_view.y = 0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <SDL.h>
+
+// 2D camera: which part of the world is on screen.
+// The view is kept in whole pixels so tiles never shimmer.
+class Camera
+{
+public:
+    // Screen (renderer output) size in pixels
+    void SetViewSize(int w, int h);
+
+    // Level size in pixels; the view never leaves it
+    void SetWorldSize(int w, int h);
+
+    // Center the view on a world point (clamped to the world)
+    void CenterOn(float worldX, float worldY);
+
+    // Visible world rectangle
+    const SDL_Rect& GetView() const { return m_view; }
+
+    SDL_Point ScreenToWorld(int screenX, int screenY) const;
+
+private:
+    void Clamp();
+
+    SDL_Rect m_view{ 0, 0, 1280, 720 };
+    int      m_worldW = 1280;
+    int      m_worldH = 720;
+};
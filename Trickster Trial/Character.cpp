@@ -1,78 +1,48 @@
 ﻿#include "Character.h"
-#include "TextureManager.h"
+#include "TextureAtlas.h"
+#include "AnimationSet.h"
+#include "SpriteBatch.h"
 #include "LevelDesigner.h"
+#include "GameClock.h"
 #include <iostream>
 
 Character::Character() {}
 
 Character::~Character()
 {
-    // Destroy all loaded animation textures
-    for (auto& pair : m_animations)
-    {
-        Animation& anim = pair.second;
-        if (anim.texture)
-        {
-            SDL_DestroyTexture(anim.texture);
-            anim.texture = nullptr;
-        }
-    }
+    // Animation frames live in the shared TextureAtlas / AnimationSet
 }
 
-bool Character::Init(SDL_Renderer* renderer)
+bool Character::Init(const GameClock& clock)
 {
-    // Helper lambda to load one animation sheet
-    auto loadAnim = [&](AnimState state, const std::string& fileName)
-        {
-            std::string fullPath = "assets/anim/Human/" + fileName;
-            SDL_Texture* tex = LoadAnimSheet(renderer, fullPath);
-            if (!tex)
-            {
-                std::cout << "Failed to load animation sheet: " << fullPath << "\n";
-                return false;
-            }
-
-            int texW = 0, texH = 0;
-            SDL_QueryTexture(tex, nullptr, nullptr, &texW, &texH);
-
-            Animation anim;
-            anim.texture = tex;
-            anim.frameCount = texW / m_frameWidth;
-            m_animations[state] = anim;
-
-            std::cout << "Loaded " << fullPath
-                << " with " << anim.frameCount << " frames\n";
-
-            return true;
-        };
-
-    // Anims
-    if (!loadAnim(AnimState::Idle,"Idle (78x58).png")) return false;
-    if (!loadAnim(AnimState::Run,"Run (78x58).png")) return false;
-    if (!loadAnim(AnimState::Jump,"Jump (78x58).png")) return false;
-    if (!loadAnim(AnimState::Fall,"Fall (78x58).png")) return false;
-    if (!loadAnim(AnimState::Ground,"Ground (78x58).png")) return false;
-    if (!loadAnim(AnimState::Attack,"Attack (78x58).png")) return false;
-    if (!loadAnim(AnimState::Hit,"Hit (78x58).png")) return false;
-    if (!loadAnim(AnimState::Dead,"Dead (78x58).png")) return false;
-    if (!loadAnim(AnimState::DoorIn,"Door In (78x58).png")) return false;
-    if (!loadAnim(AnimState::DoorOut,"Door Out (78x58).png")) return false;
+    m_clock = &clock;
+
+    // Anims (shared by every Character)
+    m_animSet = AnimationSet::Load<AnimState>("assets/anim/Human", m_frameWidth, m_frameHeight, {
+        { AnimState::Idle,    "Idle (78x58).png" },
+        { AnimState::Run,     "Run (78x58).png" },
+        { AnimState::Jump,    "Jump (78x58).png" },
+        { AnimState::Fall,    "Fall (78x58).png" },
+        { AnimState::Ground,  "Ground (78x58).png" },
+        { AnimState::Attack,  "Attack (78x58).png" },
+        { AnimState::Hit,     "Hit (78x58).png" },
+        { AnimState::Dead,    "Dead (78x58).png" },
+        { AnimState::DoorIn,  "Door In (78x58).png" },
+        { AnimState::DoorOut, "Door Out (78x58).png" } });
+
+    if (!m_animSet)
+        return false;
 
     m_currentState = AnimState::Idle;
     m_currentFrame = 0;
-    m_lastFrameTime = SDL_GetTicks();
+    m_lastFrameTime = m_clock->NowMs();
 
     return true;
 }
 
-SDL_Texture* Character::LoadAnimSheet(SDL_Renderer* renderer, const std::string& path)
-{
-    return TextureManager::Instance().LoadTexture(path, renderer);
-}
-
 void Character::Update()
 {
-    Uint32 now = SDL_GetTicks();
+    Uint32 now = m_clock->NowMs();
 
     // Hit stun/invincibility timers
     if (m_isHit && now >= m_hitEndTime)
@@ -99,8 +69,11 @@ void Character::Update()
 
     m_lastFrameTime += m_frameDurationMs;
 
-    Animation& anim = m_animations[m_currentState];
-    if (anim.frameCount <= 0 || !anim.texture)
+    if (!m_animSet)
+        return;
+
+    const AnimationClip& anim = m_animSet->GetClip(m_currentState);
+    if (anim.frameCount <= 0)
         return;
 
     m_currentFrame++;
@@ -149,26 +122,25 @@ void Character::Update()
     }
 }
 
-void Character::Render(SDL_Renderer* renderer)
+void Character::Render(SpriteBatch& batch) const
 {
-    Animation& anim = m_animations[m_currentState];
-    if (!anim.texture || anim.frameCount <= 0)
+    if (!m_animSet)
         return;
 
-    SDL_Rect src;
-    src.x = m_currentFrame * m_frameWidth;
-    src.y = 0;
-    src.w = m_frameWidth;
-    src.h = m_frameHeight;
+    const AnimationClip& anim = m_animSet->GetClip(m_currentState);
+    AtlasRegion region = TextureAtlas::Instance().GetRegion(anim.sprite);
+    if (!region.texture || m_currentFrame < 0 || m_currentFrame >= anim.frameCount)
+        return;
 
-    SDL_Rect dst;
-    dst.x = static_cast<int>(m_x);
-    dst.y = static_cast<int>(m_y);
-    dst.w = GetDrawWidth();
-    dst.h = GetDrawHeight();
+    SDL_Rect src = anim.frames[m_currentFrame];
+    src.x += region.rect.x;
+    src.y += region.rect.y;
+
+    SDL_FRect dst{ m_x, m_y, static_cast<float>(GetDrawWidth()), static_cast<float>(GetDrawHeight()) };
+    SDL_FRect prevDst{ m_prevX, m_prevY, dst.w, dst.h };
 
 	SDL_RendererFlip flip = m_facingRight ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL; // base art faces right
-    SDL_RenderCopyEx(renderer, anim.texture, &src, &dst, 0.0, nullptr, flip);
+    batch.Draw(region.texture, src, prevDst, dst, flip, SpriteLayer::Characters, dst.y + dst.h);
 }
 
 void Character::SetState(AnimState newState)
@@ -191,7 +163,7 @@ void Character::SetState(AnimState newState)
         ++m_attackNumber;               // unique ID per swing
         m_currentState = AnimState::Attack;
         m_currentFrame = 0;
-        m_lastFrameTime = SDL_GetTicks();
+        m_lastFrameTime = m_clock->NowMs();
         return;
     }
 
@@ -206,7 +178,7 @@ void Character::SetState(AnimState newState)
 
         m_currentState = newState;
         m_currentFrame = 0;
-        m_lastFrameTime = SDL_GetTicks();
+        m_lastFrameTime = m_clock->NowMs();
         return;
     }
 
@@ -219,13 +191,17 @@ void Character::SetState(AnimState newState)
 
     m_currentState = newState;
     m_currentFrame = 0;
-    m_lastFrameTime = SDL_GetTicks();
+    m_lastFrameTime = m_clock->NowMs();
 }
 
 void Character::SetPosition(float newX, float newY) // position for the character
 {
     m_x = newX;
     m_y = newY;
+
+    // Teleports should not be interpolated
+    m_prevX = newX;
+    m_prevY = newY;
 }
 
 void Character::MoveWithCollision(float dx, float dy, const LevelDesigner& level)
@@ -249,15 +225,7 @@ void Character::MoveWithCollision(float dx, float dy, const LevelDesigner& level
     int colRight = static_cast<int>(rightX) / tileSize;
     int rowFeet = static_cast<int>(feetY) / tileSize;
 
-    bool blockedX = false;
-    for (int c = colLeft; c <= colRight; ++c)
-    {
-        if (level.IsSolidCell(c, rowFeet))
-        {
-            blockedX = true;
-            break;
-        }
-    }
+    bool blockedX = level.IsAnySolidInRow(colLeft, colRight, rowFeet);
 
     if (!blockedX)
         m_x = newX;
@@ -277,15 +245,7 @@ void Character::MoveWithCollision(float dx, float dy, const LevelDesigner& level
     colRight = static_cast<int>(rightX) / tileSize;
     rowFeet = static_cast<int>(feetY) / tileSize;
 
-    bool blockedY = false;
-    for (int c = colLeft; c <= colRight; ++c)
-    {
-        if (level.IsSolidCell(c, rowFeet))
-        {
-            blockedY = true;
-            break;
-        }
-    }
+    bool blockedY = level.IsAnySolidInRow(colLeft, colRight, rowFeet);
 
     if (!blockedY)
         m_y = newY;
@@ -321,7 +281,7 @@ void Character::ApplyDamage(int amount)
     if (m_isDead)
         return;
 
-    Uint32 now = SDL_GetTicks();
+    Uint32 now = m_clock->NowMs();
 
     // Respect invincibility window
     if (m_isInvincible && now < m_invincibleEndTime)
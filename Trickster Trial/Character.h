@@ -1,10 +1,13 @@
 #pragma once
 
 #include <SDL.h>
-#include <map>
+#include <memory>
 #include <string>
 
 class LevelDesigner; // forward declaration
+class AnimationSet;
+class SpriteBatch;
+class GameClock;
 
 // All possible animation states for the player
 enum class AnimState
@@ -27,19 +30,27 @@ public:
     Character();
     ~Character();
 
-    bool Init(SDL_Renderer* renderer);
+    // clock = sim time source for all animation/stun/i-frame timers
+    bool Init(const GameClock& clock);
 
     // per-frame logic & drawing
     void Update();
-    void Render(SDL_Renderer* renderer);
+    // Queues the current frame (previous + current sim position, blended when drawn)
+    void Render(SpriteBatch& batch) const;
 
     // state changes (Run, Attack, Hit, etc.)
     void SetState(AnimState newState);
+    AnimState GetState() const { return m_currentState; }
 
     // pos / movement
     void SetPosition(float newX, float newY);
     void MoveWithCollision(float dx, float dy, const LevelDesigner& level);
 
+    // Fixed-step interpolation (call once at the start of every sim tick)
+    void SavePreviousPosition() { m_prevX = m_x; m_prevY = m_y; }
+    float GetRenderX(float alpha) const { return m_prevX + (m_x - m_prevX) * alpha; }
+    float GetRenderY(float alpha) const { return m_prevY + (m_y - m_prevY) * alpha; }
+
     float GetX() const { return m_x; }
     float GetY() const { return m_y; }
     int   GetWidth()  const { return GetDrawWidth(); }
@@ -59,16 +70,8 @@ public:
     void ApplyDamage(int amount);
 
 private:
-    // Simple animation data for a whole sprite sheet
-    struct Animation
-    {
-        SDL_Texture* texture = nullptr;
-        int frameCount = 0;
-    };
-
-    SDL_Texture* LoadAnimSheet(SDL_Renderer* renderer, const std::string& path);
-
-    std::map<AnimState, Animation> m_animations;
+    // Clips shared by every Character; per instance only state + frame
+    std::shared_ptr<const AnimationSet> m_animSet;
     AnimState m_currentState = AnimState::Idle;
 
     // Sprite sheet frame size
@@ -80,6 +83,9 @@ private:
     int GetDrawHeight() const { return m_frameHeight * m_drawScale; }
 
     int    m_drawScale = 2;
+
+    // Sim time source (set by Init)
+    const GameClock* m_clock = nullptr;
     Uint32 m_frameDurationMs = 100;   
     Uint32 m_lastFrameTime = 0;
     int    m_currentFrame = 0;
@@ -88,6 +94,10 @@ private:
     float m_x = 100.0f;
     float m_y = 100.0f;
 
+    // Position at the previous sim tick (for render interpolation)
+    float m_prevX = 100.0f;
+    float m_prevY = 100.0f;
+
     bool m_facingRight = true;
 
     // Attack tracking (used to avoid multi-hits per swing)
@@ -1,61 +1,37 @@
 #include "DialogueBox.h"
-#include "TextureManager.h"
+#include "TextureAtlas.h"
+#include "AnimationSet.h"
+#include "SpriteBatch.h"
+#include "GameClock.h"
 #include <iostream>
 
 DialogueBox::DialogueBox() {}
 
 DialogueBox::~DialogueBox()
 {
-    for (auto& pair : m_anims)
-    {
-        Animation& anim = pair.second;
-        if (anim.texture)
-        {
-            SDL_DestroyTexture(anim.texture);
-            anim.texture = nullptr;
-        }
-    }
+    // Animation frames live in the shared TextureAtlas / AnimationSet
 }
 
-SDL_Texture* DialogueBox::LoadAnimSheet(SDL_Renderer* renderer, const std::string& path)
+bool DialogueBox::Init(const GameClock& clock, const std::string& folderPath, int atlasGroup)
 {
-    return TextureManager::Instance().LoadTexture(path, renderer);
-}
-
-bool DialogueBox::Init(SDL_Renderer* renderer, const std::string& folderPath)
-{
-    auto loadAnim = [&](DialoguePhase phase, const std::string& fileName)
-        {
-            std::string fullPath = folderPath + "/" + fileName;
-            SDL_Texture* tex = LoadAnimSheet(renderer, fullPath);
-            if (!tex)
-            {
-                std::cout << "Failed to load dialogue sheet: " << fullPath << "\n";
-                return false;
-            }
-
-            int texW = 0, texH = 0;
-            SDL_QueryTexture(tex, nullptr, nullptr, &texW, &texH);
+    m_clock = &clock;
 
-            Animation anim;
-            anim.texture = tex;
-            anim.frameCount = texW / m_frameWidth;
-            m_anims[phase] = anim;
+    // None / Finished have no sheet (empty clips)
+    m_animSet = AnimationSet::Load<DialoguePhase>(folderPath, m_frameWidth, m_frameHeight, {
+        { DialoguePhase::ExclaimIn,  "!!! In (24x8).png" },
+        { DialoguePhase::ExclaimOut, "!!! Out (24x8).png" },
+        { DialoguePhase::AttackIn,   "Attack In (24x8).png" },
+        { DialoguePhase::AttackOut,  "Attack Out (24x8).png" } }, atlasGroup);
 
-            std::cout << "Loaded dialogue anim " << fullPath
-                << " with " << anim.frameCount << " frames\n";
-
-            return true;
-        };
-
-    if (!loadAnim(DialoguePhase::ExclaimIn, "!!! In (24x8).png")) return false;
-    if (!loadAnim(DialoguePhase::ExclaimOut, "!!! Out (24x8).png")) return false;
-    if (!loadAnim(DialoguePhase::AttackIn, "Attack In (24x8).png")) return false;
-    if (!loadAnim(DialoguePhase::AttackOut, "Attack Out (24x8).png")) return false;
+    if (!m_animSet)
+    {
+        std::cout << "Failed to load dialogue anims from " << folderPath << "\n";
+        return false;
+    }
 
     m_phase = DialoguePhase::None;
     m_currentFrame = 0;
-    m_lastFrameTime = SDL_GetTicks();
+    m_lastFrameTime = m_clock->NowMs();
     m_phaseStartTime = m_lastFrameTime;
     m_startedFrames = false;
     m_inHold = false;
@@ -67,7 +43,7 @@ void DialogueBox::Start()
 {
     m_phase = DialoguePhase::ExclaimIn;
     m_currentFrame = 0;
-    Uint32 now = SDL_GetTicks();
+    Uint32 now = m_clock->NowMs();
     m_lastFrameTime = now;
     m_phaseStartTime = now;
     m_startedFrames = false;  // wait initial delay
@@ -108,7 +84,7 @@ void DialogueBox::AdvancePhase()
     }
 
     m_currentFrame = 0;
-    Uint32 now = SDL_GetTicks();
+    Uint32 now = m_clock->NowMs();
     m_lastFrameTime = now;
     m_phaseStartTime = now;
     m_startedFrames = false;
@@ -120,7 +96,7 @@ void DialogueBox::Update()
     if (!IsPlaying())
         return;
 
-    Uint32 now = SDL_GetTicks();
+    Uint32 now = m_clock->NowMs();
 
     // Wait initial delay for this phase before animating frames
     if (!m_startedFrames)
@@ -152,8 +128,11 @@ void DialogueBox::Update()
 
     m_lastFrameTime = now;
 
-    Animation& anim = m_anims[m_phase];
-    if (anim.frameCount <= 0 || !anim.texture)
+    if (!m_animSet)
+        return;
+
+    const AnimationClip& anim = m_animSet->GetClip(m_phase);
+    if (anim.frameCount <= 0)
         return;
 
     m_currentFrame++;
@@ -177,28 +156,32 @@ void DialogueBox::Update()
     }
 }
 
-void DialogueBox::Render(SDL_Renderer* renderer, float anchorX, float anchorY)
+void DialogueBox::Render(SpriteBatch& batch, float prevAnchorX, float prevAnchorY, float anchorX, float anchorY) const
 {
     if (!IsPlaying())
         return;
 
-    Animation& anim = m_anims[m_phase];
-    if (!anim.texture || anim.frameCount <= 0)
+    if (!m_animSet)
+        return;
+
+    const AnimationClip& anim = m_animSet->GetClip(m_phase);
+    AtlasRegion region = TextureAtlas::Instance().GetRegion(anim.sprite);
+    if (!region.texture || m_currentFrame < 0 || m_currentFrame >= anim.frameCount)
         return;
 
-    SDL_Rect src;
-    src.x = m_currentFrame * m_frameWidth;
-    src.y = 0;
-    src.w = m_frameWidth;
-    src.h = m_frameHeight;
+    SDL_Rect src = anim.frames[m_currentFrame];
+    src.x += region.rect.x;
+    src.y += region.rect.y;
 
-    SDL_Rect dst;
-    dst.w = GetDrawWidth();
-    dst.h = GetDrawHeight();
+    SDL_FRect dst;
+    dst.w = static_cast<float>(GetDrawWidth());
+    dst.h = static_cast<float>(GetDrawHeight());
 
     // Hover above KING PIG's head
-    dst.x = static_cast<int>(anchorX + 5);
-    dst.y = static_cast<int>(anchorY - 20);
+    dst.x = anchorX + 5;
+    dst.y = anchorY - 20;
+
+    SDL_FRect prevDst{ prevAnchorX + 5, prevAnchorY - 20, dst.w, dst.h };
 
-    SDL_RenderCopy(renderer, anim.texture, &src, &dst);
+    batch.Draw(region.texture, src, prevDst, dst, SDL_FLIP_NONE, SpriteLayer::Effects, dst.y + dst.h);
 }
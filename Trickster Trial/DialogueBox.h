@@ -1,8 +1,13 @@
 ﻿#pragma once
 
 #include <SDL.h>
-#include <map>
+#include <memory>
 #include <string>
+#include "TextureAtlas.h"
+
+class GameClock;
+class AnimationSet;
+class SpriteBatch;
 
 // Simple state machine
 enum class DialoguePhase
@@ -21,13 +26,16 @@ public:
     DialogueBox();
     ~DialogueBox();
 
-    bool Init(SDL_Renderer* renderer, const std::string& folderPath);
+    // atlasGroup = TextureAtlas residency group of the level it plays in
+    bool Init(const GameClock& clock, const std::string& folderPath,
+        int atlasGroup = TextureAtlas::COMMON_GROUP);
 
     // Call when the player first enters Level 2
     void Start();
 
     void Update();
-    void Render(SDL_Renderer* renderer, float anchorX, float anchorY);
+    // anchor = King Pig position at the previous and current sim tick
+    void Render(SpriteBatch& batch, float prevAnchorX, float prevAnchorY, float anchorX, float anchorY) const;
 
     // Playing = any active phase before Finished
     bool IsPlaying() const {
@@ -38,15 +46,7 @@ public:
     bool IsFinished() const { return m_phase == DialoguePhase::Finished; }
 
 private:
-    struct Animation
-    {
-        SDL_Texture* texture = nullptr;
-        int frameCount = 0;
-    };
-
-    SDL_Texture* LoadAnimSheet(SDL_Renderer* renderer, const std::string& path);
-
-    std::map<DialoguePhase, Animation> m_anims;
+    std::shared_ptr<const AnimationSet> m_animSet;
 
     DialoguePhase m_phase = DialoguePhase::None;
 
@@ -57,6 +57,9 @@ private:
     int GetDrawWidth() const { return m_frameWidth * m_drawScale; }
     int GetDrawHeight() const { return m_frameHeight * m_drawScale; }
 
+    // Sim time source (set by Init)
+    const GameClock* m_clock = nullptr;
+
     // Per-frame speed
     Uint32 m_frameDurationMs = 100;   // 0.1s per frame
 
@@ -1,59 +1,36 @@
 #include "Door.h"
+#include "TextureAtlas.h"
+#include "AnimationSet.h"
+#include "SpriteBatch.h"
+#include "GameClock.h"
 #include <iostream>
 
 Door::Door() {}
 
 Door::~Door()
 {
-    for (auto& pair : m_animations)
-    {
-        Animation& anim = pair.second;
-        if (anim.texture)
-        {
-            SDL_DestroyTexture(anim.texture);
-            anim.texture = nullptr;
-        }
-    }
+    // Animation frames live in the shared TextureAtlas / AnimationSet
 }
 
-SDL_Texture* Door::LoadSheet(SDL_Renderer* renderer, const std::string& path)
+bool Door::Init(const GameClock& clock, const std::string& folderPath)
 {
-    return TextureManager::Instance().LoadTexture(path, renderer);
-}
-
-bool Door::Init(SDL_Renderer* renderer, const std::string& folderPath)
-{
-    auto loadAnim = [&](DoorAnimState state, const std::string& fileName)
-        {
-            std::string fullPath = folderPath + "/" + fileName;
-            SDL_Texture* tex = LoadSheet(renderer, fullPath);
-            if (!tex)
-            {
-                std::cout << "Failed to load door sheet: " << fullPath << "\n";
-                return false;
-            }
-
-            int texW = 0, texH = 0;
-            SDL_QueryTexture(tex, nullptr, nullptr, &texW, &texH);
+    m_clock = &clock;
 
-            Animation anim;
-            anim.texture = tex;
-            anim.frameCount = texW / m_frameWidth;
-            m_animations[state] = anim;
+    // Both doors share one set
+    m_animSet = AnimationSet::Load<DoorAnimState>(folderPath, m_frameWidth, m_frameHeight, {
+        { DoorAnimState::Idle,    "Idle.png" },
+        { DoorAnimState::Opening, "Opening (46x56).png" },
+        { DoorAnimState::Closing, "Closing (46x56).png" } });
 
-            std::cout << "Loaded door anim " << fullPath
-                << " with " << anim.frameCount << " frames\n";
-
-            return true;
-        };
-
-    if (!loadAnim(DoorAnimState::Idle, "Idle.png")) return false;
-    if (!loadAnim(DoorAnimState::Opening, "Opening (46x56).png")) return false;
-    if (!loadAnim(DoorAnimState::Closing, "Closing (46x56).png")) return false;
+    if (!m_animSet)
+    {
+        std::cout << "Failed to load door anims from " << folderPath << "\n";
+        return false;
+    }
 
     m_currentState = DoorAnimState::Idle;
     m_currentFrame = 0;
-    m_lastFrameTime = SDL_GetTicks();
+    m_lastFrameTime = m_clock->NowMs();
 
     return true;
 }
@@ -89,19 +66,22 @@ void Door::SetState(DoorAnimState newState)
 
     m_currentState = newState;
     m_currentFrame = 0;
-    m_lastFrameTime = SDL_GetTicks();
+    m_lastFrameTime = m_clock->NowMs();
 }
 
 void Door::Update()
 {
-    Uint32 now = SDL_GetTicks();
+    Uint32 now = m_clock->NowMs();
     if (now - m_lastFrameTime < m_frameDurationMs)
         return;
 
     m_lastFrameTime += m_frameDurationMs;
 
-    Animation& anim = m_animations[m_currentState];
-    if (anim.frameCount <= 0 || !anim.texture)
+    if (!m_animSet)
+        return;
+
+    const AnimationClip& anim = m_animSet->GetClip(m_currentState);
+    if (anim.frameCount <= 0)
         return;
 
     m_currentFrame++;
@@ -123,23 +103,21 @@ void Door::Update()
     }
 }
 
-void Door::Render(SDL_Renderer* renderer)
+void Door::Render(SpriteBatch& batch) const
 {
-    Animation& anim = m_animations[m_currentState];
-    if (!anim.texture || anim.frameCount <= 0)
+    if (!m_animSet)
+        return;
+
+    const AnimationClip& anim = m_animSet->GetClip(m_currentState);
+    AtlasRegion region = TextureAtlas::Instance().GetRegion(anim.sprite);
+    if (!region.texture || m_currentFrame < 0 || m_currentFrame >= anim.frameCount)
         return;
 
-    SDL_Rect src;
-    src.x = m_currentFrame * m_frameWidth;
-    src.y = 0;
-    src.w = m_frameWidth;
-    src.h = m_frameHeight;
+    SDL_Rect src = anim.frames[m_currentFrame];
+    src.x += region.rect.x;
+    src.y += region.rect.y;
 
-    SDL_Rect dst;
-    dst.x = static_cast<int>(m_x);
-    dst.y = static_cast<int>(m_y);
-    dst.w = GetDrawWidth();
-    dst.h = GetDrawHeight();
+    SDL_FRect dst{ m_x, m_y, static_cast<float>(GetDrawWidth()), static_cast<float>(GetDrawHeight()) };
 
-    SDL_RenderCopy(renderer, anim.texture, &src, &dst);
+    batch.Draw(region.texture, src, dst, SDL_FLIP_NONE, SpriteLayer::Props, dst.y + dst.h);
 }
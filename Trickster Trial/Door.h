@@ -1,9 +1,12 @@
 #pragma once
 
 #include <SDL.h>
+#include <memory>
 #include <string>
-#include <map>
-#include "TextureManager.h"
+
+class GameClock;
+class AnimationSet;
+class SpriteBatch;
 
 // Simple 3-state door animation
 enum class DoorAnimState
@@ -19,10 +22,10 @@ public:
     Door();
     ~Door();
 
-    bool Init(SDL_Renderer* renderer, const std::string& folderPath);
+    bool Init(const GameClock& clock, const std::string& folderPath);
 
     void Update();
-    void Render(SDL_Renderer* renderer);
+    void Render(SpriteBatch& batch) const;
 
     void SetState(DoorAnimState newState);
     void SetPosition(float x, float y);
@@ -38,15 +41,8 @@ public:
     float GetTargetY() const { return m_targetY; }
 
 private:
-    struct Animation
-    {
-        SDL_Texture* texture = nullptr;
-        int frameCount = 0;
-    };
-
-    SDL_Texture* LoadSheet(SDL_Renderer* renderer, const std::string& path);
-
-    std::map<DoorAnimState, Animation> m_animations;
+    // Clips shared by all doors
+    std::shared_ptr<const AnimationSet> m_animSet;
     DoorAnimState m_currentState = DoorAnimState::Idle;
 
     // Sprite sheet frame
@@ -59,6 +55,7 @@ private:
     int GetDrawHeight() const {return m_frameHeight * m_drawScale;}
 
     // Animation timing
+    const GameClock* m_clock = nullptr;
     Uint32 m_frameDurationMs = 100;   // 10 FPS
     Uint32 m_lastFrameTime = 0;
     int m_currentFrame = 0;
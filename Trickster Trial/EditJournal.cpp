@@ -0,0 +1,136 @@
+#include "EditJournal.h"
+#include "ByteIO.h"
+#include <cstring>
+
+namespace
+{
+    const char   JOURNAL_MAGIC[4] = { 'T', 'T', 'J', 'L' };
+    const Uint32 JOURNAL_VERSION = 1;
+}
+
+const size_t EditJournal::FILE_HEADER_SIZE;
+const size_t EditJournal::FILE_RECORD_SIZE;
+
+void EditJournal::BeginStroke()
+{
+    m_history.resize(m_cursor);
+    ++m_stroke;
+}
+
+void EditJournal::Record(int col, int row, int layer, Uint16 oldTile, Uint16 newTile)
+{
+    EditRecord record;
+    record.col = static_cast<Uint16>(col);
+    record.row = static_cast<Uint16>(row);
+    record.layer = static_cast<Uint8>(layer);
+    record.oldTile = oldTile;
+    record.newTile = newTile;
+    record.stroke = m_stroke;
+
+    // Recording without BeginStroke() (e.g. after an undo) must not
+    // keep a stale redo tail either
+    m_history.resize(m_cursor);
+    m_history.push_back(record);
+    m_cursor = m_history.size();
+
+    m_pending.push_back(record);
+}
+
+bool EditJournal::Undo(std::vector<EditRecord>& outRecords)
+{
+    outRecords.clear();
+    if (m_cursor == 0)
+        return false;
+
+    const Uint32 stroke = m_history[m_cursor - 1].stroke;
+    while (m_cursor > 0 && m_history[m_cursor - 1].stroke == stroke)
+    {
+        const EditRecord& record = m_history[--m_cursor];
+        outRecords.push_back(record);
+
+        // The sidecar logs what happened to the grid: old -> new swapped
+        EditRecord applied = record;
+        applied.oldTile = record.newTile;
+        applied.newTile = record.oldTile;
+        m_pending.push_back(applied);
+    }
+
+    return true;
+}
+
+bool EditJournal::Redo(std::vector<EditRecord>& outRecords)
+{
+    outRecords.clear();
+    if (m_cursor >= m_history.size())
+        return false;
+
+    const Uint32 stroke = m_history[m_cursor].stroke;
+    while (m_cursor < m_history.size() && m_history[m_cursor].stroke == stroke)
+    {
+        const EditRecord& record = m_history[m_cursor++];
+        outRecords.push_back(record);
+        m_pending.push_back(record);
+    }
+
+    return true;
+}
+
+void EditJournal::Clear()
+{
+    m_history.clear();
+    m_cursor = 0;
+    m_pending.clear();
+}
+
+void EditJournal::TakePending(std::vector<Uint8>& bytes, bool withHeader)
+{
+    const size_t headerSize = withHeader ? FILE_HEADER_SIZE : 0;
+    bytes.assign(headerSize + m_pending.size() * FILE_RECORD_SIZE, 0);
+
+    if (withHeader)
+    {
+        std::memcpy(bytes.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        WriteU32(bytes.data() + 4, JOURNAL_VERSION);
+        WriteU32(bytes.data() + 8, static_cast<Uint32>(FILE_RECORD_SIZE));
+    }
+
+    Uint8* p = bytes.data() + headerSize;
+    for (const EditRecord& record : m_pending)
+    {
+        WriteU16(p + 0, record.col);
+        WriteU16(p + 2, record.row);
+        p[4] = record.layer;
+        WriteU16(p + 6, record.oldTile);
+        WriteU16(p + 8, record.newTile);
+        WriteU32(p + 12, record.stroke);
+        p += FILE_RECORD_SIZE;
+    }
+
+    m_pending.clear();
+}
+
+bool EditJournal::ReadFile(const Uint8* data, size_t size, std::vector<EditRecord>& outRecords)
+{
+    outRecords.clear();
+
+    if (size < FILE_HEADER_SIZE || std::memcmp(data, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 ||
+        ReadU32(data + 4) != JOURNAL_VERSION || ReadU32(data + 8) != FILE_RECORD_SIZE)
+        return false;
+
+    const size_t count = (size - FILE_HEADER_SIZE) / FILE_RECORD_SIZE;
+    outRecords.resize(count);
+
+    const Uint8* p = data + FILE_HEADER_SIZE;
+    for (EditRecord& record : outRecords)
+    {
+        record.col = ReadU16(p + 0);
+        record.row = ReadU16(p + 2);
+        record.layer = p[4];
+        record.oldTile = ReadU16(p + 6);
+        record.newTile = ReadU16(p + 8);
+        record.stroke = ReadU32(p + 12);
+        p += FILE_RECORD_SIZE;
+    }
+
+    return true;
+}
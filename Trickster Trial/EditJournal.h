@@ -0,0 +1,63 @@
+#pragma once
+
+#include <SDL.h>
+#include <vector>
+
+// One cell change made in the editor
+struct EditRecord
+{
+    Uint16 col = 0;
+    Uint16 row = 0;
+    Uint8  layer = 0;
+    Uint16 oldTile = 0;
+    Uint16 newTile = 0;
+    Uint32 stroke = 0;   // records of one mouse stroke share an id
+};
+
+// Append-only history of editor changes for one level.
+//  - Undo()/Redo() step through it one stroke at a time.
+//  - Everything applied to the grid (edits, undos, redos) is also
+//    queued for a sidecar file next to the level, so saving a stroke
+//    costs O(edits) instead of rewriting the whole map. Replaying the
+//    sidecar over the last full save gives the current grid.
+class EditJournal
+{
+public:
+    // Sidecar file: "TTJL", version, record size, then fixed-size
+    // little-endian records (col, row, layer, old, new, stroke)
+    static const size_t FILE_HEADER_SIZE = 12;
+    static const size_t FILE_RECORD_SIZE = 16;
+
+    // Start a new stroke; drops anything that could still be redone
+    void BeginStroke();
+    void Record(int col, int row, int layer, Uint16 oldTile, Uint16 newTile);
+
+    // Records of the stroke to take back (newest first: apply oldTile)
+    // or to apply again (oldest first: apply newTile). false = nothing.
+    bool Undo(std::vector<EditRecord>& outRecords);
+    bool Redo(std::vector<EditRecord>& outRecords);
+
+    bool CanUndo() const { return m_cursor > 0; }
+    bool CanRedo() const { return m_cursor < m_history.size(); }
+
+    // Forget the history (after changes the journal can't express, like
+    // a resize) and anything not yet written
+    void Clear();
+
+    size_t GetHistorySize() const { return m_history.size(); }
+    size_t GetPendingCount() const { return m_pending.size(); }
+
+    // Changes since the last call, as sidecar bytes (with the file
+    // header when starting a new file). Clears the pending list.
+    void TakePending(std::vector<Uint8>& bytes, bool withHeader);
+
+    // Records of a sidecar file; a torn record at the end (crash while
+    // appending) is ignored. false = not a journal.
+    static bool ReadFile(const Uint8* data, size_t size, std::vector<EditRecord>& outRecords);
+
+private:
+    std::vector<EditRecord> m_history;   // [0, m_cursor) applied, the rest can be redone
+    size_t                  m_cursor = 0;
+    Uint32                  m_stroke = 0;
+    std::vector<EditRecord> m_pending;   // applied, not in the sidecar yet
+};
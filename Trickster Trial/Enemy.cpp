@@ -1,70 +1,44 @@
 ﻿#include "Enemy.h"
-#include "TextureManager.h"
+#include "TextureAtlas.h"
+#include "AnimationSet.h"
+#include "SpriteBatch.h"
 #include "LevelDesigner.h"
+#include "GameClock.h"
 #include <iostream>
 
 Enemy::Enemy() {}
 
 Enemy::~Enemy()
 {
-    for (auto& pair : m_animations)
-    {
-        Animation& anim = pair.second;
-        if (anim.texture)
-        {
-            SDL_DestroyTexture(anim.texture);
-            anim.texture = nullptr;
-        }
-    }
-}
-
-SDL_Texture* Enemy::LoadAnimSheet(SDL_Renderer* renderer, const std::string& path)
-{
-    return TextureManager::Instance().LoadTexture(path, renderer);
+    // Animation frames live in the shared TextureAtlas / AnimationSet
 }
 
 // King Pig 
 
-bool Enemy::InitKingPig(SDL_Renderer* renderer, const std::string& folderPath)
+bool Enemy::InitKingPig(const GameClock& clock, const std::string& folderPath, int atlasGroup)
 {
-    m_animations.clear();
+    m_clock = &clock;
 
     m_frameWidth = 38;
     m_frameHeight = 28;
 
-    auto loadAnim = [&](EnemyAnimState state, const std::string& fileName)
-        {
-            std::string fullPath = folderPath + "/" + fileName;
-            SDL_Texture* tex = LoadAnimSheet(renderer, fullPath);
-            if (!tex)
-            {
-                std::cout << "Failed to load King Pig sheet: " << fullPath << "\n";
-                return false;
-            }
-
-            int texW = 0, texH = 0;
-            SDL_QueryTexture(tex, nullptr, nullptr, &texW, &texH);
-
-            Animation anim;
-            anim.texture = tex;
-            anim.frameCount = texW / m_frameWidth;
-            m_animations[state] = anim;
-
-            std::cout << "Loaded King Pig anim " << fullPath
-                << " with " << anim.frameCount << " frames\n";
-
-            return true;
-        };
-
-    if (!loadAnim(EnemyAnimState::Idle, "Idle (38x28).png")) return false;
-    if (!loadAnim(EnemyAnimState::Run, "Run (38x28).png")) return false;
-    if (!loadAnim(EnemyAnimState::Attack, "Attack (38x28).png")) return false;
-    if (!loadAnim(EnemyAnimState::Hit, "Hit (38x28).png")) return false;
-    if (!loadAnim(EnemyAnimState::Dead, "Dead (38x28).png")) return false;
+    // Every King Pig shares one set
+    m_animSet = AnimationSet::Load<EnemyAnimState>(folderPath, m_frameWidth, m_frameHeight, {
+        { EnemyAnimState::Idle,   "Idle (38x28).png" },
+        { EnemyAnimState::Run,    "Run (38x28).png" },
+        { EnemyAnimState::Attack, "Attack (38x28).png" },
+        { EnemyAnimState::Hit,    "Hit (38x28).png" },
+        { EnemyAnimState::Dead,   "Dead (38x28).png" } }, atlasGroup);
+
+    if (!m_animSet)
+    {
+        std::cout << "Failed to load King Pig anims from " << folderPath << "\n";
+        return false;
+    }
 
     m_currentState = EnemyAnimState::Idle;
     m_currentFrame = 0;
-    m_lastFrameTime = SDL_GetTicks();
+    m_lastFrameTime = m_clock->NowMs();
     m_facingRight = false; // base art faces left
     m_maxHealth = 5;
     m_health = 5;
@@ -78,46 +52,30 @@ bool Enemy::InitKingPig(SDL_Renderer* renderer, const std::string& folderPath)
 
 // Minion Pig 
 
-bool Enemy::InitPig(SDL_Renderer* renderer, const std::string& folderPath)
+bool Enemy::InitPig(const GameClock& clock, const std::string& folderPath, int atlasGroup)
 {
-    m_animations.clear();
+    m_clock = &clock;
 
     m_frameWidth = 34;
     m_frameHeight = 28;
 
-    auto loadAnim = [&](EnemyAnimState state, const std::string& fileName)
-        {
-            std::string fullPath = folderPath + "/" + fileName;
-            SDL_Texture* tex = LoadAnimSheet(renderer, fullPath);
-            if (!tex)
-            {
-                std::cout << "Failed to load Pig sheet: " << fullPath << "\n";
-                return false;
-            }
-
-            int texW = 0, texH = 0;
-            SDL_QueryTexture(tex, nullptr, nullptr, &texW, &texH);
-
-            Animation anim;
-            anim.texture = tex;
-            anim.frameCount = texW / m_frameWidth;
-            m_animations[state] = anim;
-
-            std::cout << "Loaded Pig anim " << fullPath
-                << " with " << anim.frameCount << " frames\n";
-
-            return true;
-        };
-
-    if (!loadAnim(EnemyAnimState::Idle, "Idle (34x28).png")) return false;
-    if (!loadAnim(EnemyAnimState::Run, "Run (34x28).png")) return false;
-    if (!loadAnim(EnemyAnimState::Attack, "Attack (34x28).png")) return false;
-    if (!loadAnim(EnemyAnimState::Hit, "Hit (34x28).png")) return false;
-    if (!loadAnim(EnemyAnimState::Dead, "Dead (34x28).png")) return false;
+    // Every minion pig shares one set
+    m_animSet = AnimationSet::Load<EnemyAnimState>(folderPath, m_frameWidth, m_frameHeight, {
+        { EnemyAnimState::Idle,   "Idle (34x28).png" },
+        { EnemyAnimState::Run,    "Run (34x28).png" },
+        { EnemyAnimState::Attack, "Attack (34x28).png" },
+        { EnemyAnimState::Hit,    "Hit (34x28).png" },
+        { EnemyAnimState::Dead,   "Dead (34x28).png" } }, atlasGroup);
+
+    if (!m_animSet)
+    {
+        std::cout << "Failed to load Pig anims from " << folderPath << "\n";
+        return false;
+    }
 
     m_currentState = EnemyAnimState::Idle;
     m_currentFrame = 0;
-    m_lastFrameTime = SDL_GetTicks();
+    m_lastFrameTime = m_clock->NowMs();
     m_facingRight = false;
     m_maxHealth = 3;
     m_health = 3;
@@ -135,6 +93,10 @@ void Enemy::SetPosition(float x, float y)
 {
     m_x = x;
     m_y = y;
+
+    // Teleports should not be interpolated
+    m_prevX = x;
+    m_prevY = y;
 }
 
 void Enemy::SetState(EnemyAnimState newState)
@@ -153,12 +115,12 @@ void Enemy::SetState(EnemyAnimState newState)
 
     m_currentState = newState;
     m_currentFrame = 0;
-    m_lastFrameTime = SDL_GetTicks();
+    m_lastFrameTime = m_clock->NowMs();
 }
 
 void Enemy::Update()
 {
-    Uint32 now = SDL_GetTicks();
+    Uint32 now = m_clock->NowMs();
 
     // End of hit-stun
     if (m_isHit && !m_isDead && now >= m_hitEndTime)
@@ -179,8 +141,11 @@ void Enemy::Update()
 
     m_lastFrameTime += m_frameDurationMs;
 
-    Animation& anim = m_animations[m_currentState];
-    if (anim.frameCount <= 0 || !anim.texture)
+    if (!m_animSet)
+        return;
+
+    const AnimationClip& anim = m_animSet->GetClip(m_currentState);
+    if (anim.frameCount <= 0)
         return;
 
     m_currentFrame++;
@@ -207,27 +172,26 @@ void Enemy::Update()
     }
 }
 
-void Enemy::Render(SDL_Renderer* renderer)
+void Enemy::Render(SpriteBatch& batch) const
 {
-    Animation& anim = m_animations[m_currentState];
-    if (!anim.texture || anim.frameCount <= 0)
+    if (!m_animSet)
         return;
 
-    SDL_Rect src;
-    src.x = m_currentFrame * m_frameWidth;
-    src.y = 0;
-    src.w = m_frameWidth;
-    src.h = m_frameHeight;
+    const AnimationClip& anim = m_animSet->GetClip(m_currentState);
+    AtlasRegion region = TextureAtlas::Instance().GetRegion(anim.sprite);
+    if (!region.texture || m_currentFrame < 0 || m_currentFrame >= anim.frameCount)
+        return;
+
+    SDL_Rect src = anim.frames[m_currentFrame];
+    src.x += region.rect.x;
+    src.y += region.rect.y;
 
-    SDL_Rect dst;
-    dst.x = static_cast<int>(m_x);
-    dst.y = static_cast<int>(m_y);
-    dst.w = GetDrawWidth();
-    dst.h = GetDrawHeight();
+    SDL_FRect dst{ m_x, m_y, static_cast<float>(GetDrawWidth()), static_cast<float>(GetDrawHeight()) };
+    SDL_FRect prevDst{ m_prevX, m_prevY, dst.w, dst.h };
 
     // Base art faces LEFT; facingRight=true means flip to RIGHT
     SDL_RendererFlip flip = m_facingRight ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
-    SDL_RenderCopyEx(renderer, anim.texture, &src, &dst, 0.0, nullptr, flip);
+    batch.Draw(region.texture, src, prevDst, dst, flip, SpriteLayer::Characters, dst.y + dst.h);
 }
 
 void Enemy::MoveWithCollision(float dx, float dy, const LevelDesigner& level)
@@ -250,15 +214,7 @@ void Enemy::MoveWithCollision(float dx, float dy, const LevelDesigner& level)
     int colRight = static_cast<int>(rightX) / tileSize;
     int rowFeet = static_cast<int>(feetY) / tileSize;
 
-    bool blockedX = false;
-    for (int c = colLeft; c <= colRight; ++c)
-    {
-        if (level.IsSolidCell(c, rowFeet))
-        {
-            blockedX = true;
-            break;
-        }
-    }
+    bool blockedX = level.IsAnySolidInRow(colLeft, colRight, rowFeet);
 
     if (!blockedX)
         m_x = newX;
@@ -274,15 +230,7 @@ void Enemy::MoveWithCollision(float dx, float dy, const LevelDesigner& level)
     colRight = static_cast<int>(rightX) / tileSize;
     rowFeet = static_cast<int>(feetY) / tileSize;
 
-    bool blockedY = false;
-    for (int c = colLeft; c <= colRight; ++c)
-    {
-        if (level.IsSolidCell(c, rowFeet))
-        {
-            blockedY = true;
-            break;
-        }
-    }
+    bool blockedY = level.IsAnySolidInRow(colLeft, colRight, rowFeet);
 
     if (!blockedY)
         m_y = newY;
@@ -307,13 +255,13 @@ void Enemy::ApplyDamage(int amount, unsigned int attackNumber)
         m_isHit = false;
         m_currentState = EnemyAnimState::Dead;
         m_currentFrame = 0;
-        m_lastFrameTime = SDL_GetTicks();
+        m_lastFrameTime = m_clock->NowMs();
         return;
     }
 
     // Still alive → hit-stun
     m_isHit = true;
-    Uint32 now = SDL_GetTicks();
+    Uint32 now = m_clock->NowMs();
     m_hitEndTime = now + 250; // 0.25s stagger
     m_currentState = EnemyAnimState::Hit;
     m_currentFrame = 0;
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <SDL.h>
-#include <map>
+#include <memory>
 #include <string>
+#include "TextureAtlas.h"
 
 class LevelDesigner;
+class AnimationSet;
+class SpriteBatch;
+class GameClock;
 
 // Shared animation states for both minion + king pigs
 enum class EnemyAnimState
@@ -22,13 +26,18 @@ public:
     Enemy();
     ~Enemy();
 
+    // atlasGroup = TextureAtlas residency group of the level the pig lives in
+
     // Boss init
-    bool InitKingPig(SDL_Renderer* renderer, const std::string& folderPath);
+    bool InitKingPig(const GameClock& clock, const std::string& folderPath,
+        int atlasGroup = TextureAtlas::COMMON_GROUP);
     // Minion init
-    bool InitPig(SDL_Renderer* renderer, const std::string& folderPath);
+    bool InitPig(const GameClock& clock, const std::string& folderPath,
+        int atlasGroup = TextureAtlas::COMMON_GROUP);
 
     void Update();
-    void Render(SDL_Renderer* renderer);
+    // Queues the current frame (previous + current sim position, blended when drawn)
+    void Render(SpriteBatch& batch) const;
 
     void SetState(EnemyAnimState newState);
 
@@ -36,6 +45,11 @@ public:
     float GetX() const { return m_x; }
     float GetY() const { return m_y; }
 
+    // Fixed-step interpolation (call once at the start of every sim tick)
+    void SavePreviousPosition() { m_prevX = m_x; m_prevY = m_y; }
+    float GetRenderX(float alpha) const { return m_prevX + (m_x - m_prevX) * alpha; }
+    float GetRenderY(float alpha) const { return m_prevY + (m_y - m_prevY) * alpha; }
+
     int  GetWidth()  const { return GetDrawWidth(); }
     int  GetHeight() const { return GetDrawHeight(); }
 
@@ -49,18 +63,12 @@ public:
     void ApplyDamage(int amount, unsigned int attackNumber);
 
     bool IsDead() const { return m_isDead; }
+    int  GetHealth() const { return m_health; }
     bool IsStunned() const { return m_isHit; }
 
 private:
-    struct Animation
-    {
-        SDL_Texture* texture = nullptr;
-        int frameCount = 0;
-    };
-
-    SDL_Texture* LoadAnimSheet(SDL_Renderer* renderer, const std::string& path);
-
-    std::map<EnemyAnimState, Animation> m_animations;
+    // Clips shared by every pig of the same kind (king / minion)
+    std::shared_ptr<const AnimationSet> m_animSet;
     EnemyAnimState m_currentState = EnemyAnimState::Idle;
 
     // Sprite frame size (set by which Init* we use)
@@ -72,6 +80,9 @@ private:
     int GetDrawHeight() const { return m_frameHeight * m_drawScale; }
     int m_drawScale = 2;
 
+    // Sim time source (set by Init*)
+    const GameClock* m_clock = nullptr;
+
     // Animation timing
     Uint32 m_frameDurationMs = 100;
     Uint32 m_lastFrameTime = 0;
@@ -81,6 +92,10 @@ private:
     float m_x = 0.0f;
     float m_y = 0.0f;
 
+    // Position at the previous sim tick (for render interpolation)
+    float m_prevX = 0.0f;
+    float m_prevY = 0.0f;
+
     bool m_facingRight = false;
 
     int m_health = 1;
@@ -0,0 +1,885 @@
+﻿#include "Game.h"
+#include "TextureAtlas.h"
+#include "RenderSnapshot.h"
+#include "Profiler.h"
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+    const int MINION_COUNT = 3;
+
+    const int LIVE_BAR_FULL_W = 66;
+    const int LIVE_BAR_H = 34;
+    const int HEART_W = LIVE_BAR_FULL_W / 3; // 3 hearts
+
+    const Uint32 DOOR_PHASE_MS = 600; // ms per door phase
+
+    const float DOOR_USE_RADIUS = 80.0f;        // F works within this
+    const float DOOR_PREFETCH_RADIUS = 320.0f;  // start loading the level behind the door
+
+    // FNV-1a, 32 bit
+    const Uint32 FNV_OFFSET = 2166136261u;
+    const Uint32 FNV_PRIME = 16777619u;
+
+    void HashBytes(Uint32& hash, const void* data, size_t size)
+    {
+        const Uint8* bytes = static_cast<const Uint8*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+    }
+
+    void HashInt(Uint32& hash, int value)
+    {
+        HashBytes(hash, &value, sizeof(value));
+    }
+
+    void HashFloat(Uint32& hash, float value)
+    {
+        HashBytes(hash, &value, sizeof(value)); // exact bits, no tolerance
+    }
+}
+
+Game::Game() {}
+
+Game::~Game()
+{
+    // Atlas pages belong to this renderer
+    TextureAtlas::Instance().Clear();
+}
+
+bool Game::Init(SDL_Renderer* renderer)
+{
+    // Level tiles
+
+    if (!m_levelDesigner.Init(renderer))
+    {
+        std::cout << "Failed to init LevelDesigner\n";
+        return false;
+    }
+
+    // Disable paint mode by default (F1/F2 to edit levels)
+    m_levelDesigner.paintingEnabled = false;
+
+    // Headless runs (soak/replay/bench) must never rewrite the level files
+    if (!renderer)
+        m_levelDesigner.autoSaveEnabled = false;
+
+    // Player
+
+    if (!m_player.Init(m_clock))
+    {
+        std::cout << "Failed to init Character\n";
+        return false;
+    }
+
+    // Start in Level 1
+    m_player.SetPosition(5.0f, 280.0f);
+    m_playerLevelIndex = 0;
+
+    // Doors (tunnels between levels), as declared in the level manifest
+
+    std::string doorFolder = "assets/anim/Door";
+
+    const std::vector<LevelRegistry::DoorLink>& doorLinks = m_levelDesigner.GetRegistry().GetDoors();
+    m_doors.resize(doorLinks.size());
+
+    for (size_t i = 0; i < doorLinks.size(); ++i)
+    {
+        const LevelRegistry::DoorLink& link = doorLinks[i];
+
+        if (!m_doors[i].Init(m_clock, doorFolder))
+        {
+            std::cout << "Failed to init Door(s)\n";
+            return false;
+        }
+
+        m_doors[i].SetPosition(link.x, link.y);
+
+        // Where the player appears after using the door
+        m_doors[i].SetTravelTarget(link.fromLevel, link.toLevel, link.targetX, link.targetY);
+    }
+
+    // Enemies
+
+    // Pigs and their dialogue only appear in the manifest's enemy level,
+    // so their sheets are only resident while it is (or is about to be)
+    // active
+    const int enemyLevel = m_levelDesigner.GetRegistry().GetEnemyLevel();
+    const int enemyGroup = enemyLevel >= 0 ? TextureAtlas::LevelGroup(enemyLevel) : TextureAtlas::COMMON_GROUP;
+
+    if (!m_kingPig.InitKingPig(m_clock, "assets/anim/King Pig", enemyGroup))
+    {
+        std::cout << "Failed to init King Pig\n";
+        return false;
+    }
+
+    // King is on the right side of the enemy level
+    m_kingPig.SetPosition(1170.0f, 280.0f);
+
+    // Minion pigs (all live in the enemy level)
+    m_minionPigs.resize(MINION_COUNT);
+
+    for (int i = 0; i < MINION_COUNT; ++i)
+    {
+        if (!m_minionPigs[i].InitPig(m_clock, "assets/anim/Pig", enemyGroup))
+        {
+            std::cout << "Failed to init Minion Pig " << i << "\n";
+            return false;
+        }
+    }
+
+    // Initial positions for pigs
+    m_minionPigs[0].SetPosition(600.0f, 20.0f);
+    m_minionPigs[1].SetPosition(600.0f, 610.0f);
+    m_minionPigs[2].SetPosition(1000.0f, 280.0f);
+
+    // UI: life bar
+
+    int liveBarW = 0, liveBarH = 0;
+    m_liveBarSprite = TextureAtlas::Instance().AddSheet("assets/anim/Live and Coins/Live Bar.png", liveBarW, liveBarH);
+    if (m_liveBarSprite < 0)
+    {
+        std::cout << "Failed to load Live Bar UI\n";
+        return false;
+    }
+
+    // King Pig dialogue
+
+    if (!m_kingPigDialogue.Init(m_clock, "assets/anim/Dialogue Boxes", enemyGroup))
+    {
+        std::cout << "Failed to init King Pig dialogue\n";
+        return false;
+    }
+
+    // Every sheet is registered now: pack the ones the starting level
+    // needs into atlas pages and start decoding them in the background
+    // (headless only needed the sizes). FinishLoading() uploads them.
+
+    {
+        std::lock_guard<std::mutex> lock(m_levelMutex);
+        SyncAssetResidency(m_clock.GetTickCount());
+    }
+
+    if (!TextureAtlas::Instance().BeginBuild(renderer))
+    {
+        std::cout << "Failed to build texture atlas\n";
+        return false;
+    }
+
+    return true;
+}
+
+float Game::GetLoadingProgress() const
+{
+    return TextureAtlas::Instance().GetBuildProgress();
+}
+
+bool Game::IsLoadingDone() const
+{
+    return TextureAtlas::Instance().IsBuildReady();
+}
+
+bool Game::FinishLoading(SDL_Renderer* renderer)
+{
+    if (!TextureAtlas::Instance().FinishBuild(renderer))
+    {
+        std::cout << "Failed to build texture atlas\n";
+        return false;
+    }
+
+    return true;
+}
+
+void Game::HandleEvent(const SDL_Event& e)
+{
+    // Editor edits come from the main thread while the sim may be ticking
+    std::lock_guard<std::mutex> lock(m_levelMutex);
+    m_levelDesigner.HandleEvent(e, m_camera);
+
+    // F1/F2 may have switched the level. The latest snapshot can
+    // already be built, so the old level's sheets go one tick later.
+    SyncAssetResidency(m_clock.GetTickCount() + 1);
+}
+
+void Game::SyncAssetResidency(Uint64 releaseTick)
+{
+    // Sheets follow the level cache: levels still decoded keep theirs
+    // uploaded (going back is instant), evicted ones release them
+    std::vector<int> wanted;
+    wanted.push_back(TextureAtlas::COMMON_GROUP);
+
+    m_levelDesigner.GetCachedLevels(m_cachedLevels);
+    for (int level : m_cachedLevels)
+        wanted.push_back(TextureAtlas::LevelGroup(level));
+
+    // Near a door: start loading the level behind it so it's ready by
+    // the time the door animation ends
+    if (m_prefetchLevel >= 0 && !m_levelDesigner.IsLevelCached(m_prefetchLevel))
+        wanted.push_back(TextureAtlas::LevelGroup(m_prefetchLevel));
+
+    if (wanted == m_wantedAtlasGroups)
+        return;
+
+    m_wantedAtlasGroups = wanted;
+    TextureAtlas::Instance().SetWantedGroups(wanted, releaseTick);
+}
+
+int Game::GetDeadPigCount() const
+{
+    int dead = 0;
+    for (const Enemy& pig : m_minionPigs)
+    {
+        if (pig.IsDead())
+            ++dead;
+    }
+    return dead;
+}
+
+Uint32 Game::HashState() const
+{
+    std::lock_guard<std::mutex> lock(m_levelMutex);
+
+    Uint32 hash = FNV_OFFSET;
+
+    HashInt(hash, static_cast<int>(m_clock.GetTickCount()));
+
+    HashFloat(hash, m_player.GetX());
+    HashFloat(hash, m_player.GetY());
+    HashInt(hash, m_player.GetHealth());
+    HashInt(hash, static_cast<int>(m_player.GetState()));
+
+    for (const Enemy& pig : m_minionPigs)
+    {
+        HashFloat(hash, pig.GetX());
+        HashFloat(hash, pig.GetY());
+        HashInt(hash, pig.GetHealth());
+        HashInt(hash, static_cast<int>(pig.GetState()));
+    }
+
+    HashFloat(hash, m_kingPig.GetX());
+    HashFloat(hash, m_kingPig.GetY());
+    HashInt(hash, m_kingPig.GetHealth());
+    HashInt(hash, static_cast<int>(m_kingPig.GetState()));
+
+    HashInt(hash, static_cast<int>(m_travelState));
+    HashInt(hash, m_playerLevelIndex);
+    HashInt(hash, m_levelDesigner.GetActiveLevel());
+
+    return hash;
+}
+
+void Game::PrefetchDoorTargets()
+{
+    int target = -1;
+
+    if (m_travelState == DoorTravelState::GoingIn && m_activeDoor)
+    {
+        target = m_activeDoor->GetToLevel();
+    }
+    else if (m_travelState == DoorTravelState::None && m_levelDesigner.GetActiveLevel() == m_playerLevelIndex)
+    {
+        for (int door : m_levelDesigner.GetRegistry().GetDoorsIn(m_playerLevelIndex))
+        {
+            if (IsPlayerNearDoor(m_doors[door], DOOR_PREFETCH_RADIUS))
+            {
+                target = m_doors[door].GetToLevel();
+                break;
+            }
+        }
+    }
+
+    m_prefetchLevel = target;
+    if (target >= 0)
+        m_levelDesigner.PrefetchLevel(target);
+}
+
+bool Game::IsPlayerNearDoor(const Door& d, float radius) const
+{
+    SDL_FRect doorRect = d.GetBounds();
+
+    float px = m_player.GetX() + m_player.GetWidth() * 0.5f;
+    float py = m_player.GetY() + m_player.GetHeight() * 0.5f;
+
+    float dx = px - (doorRect.x + doorRect.w * 0.5f);
+    float dy = py - (doorRect.y + doorRect.h * 0.5f);
+
+    float distSq = dx * dx + dy * dy;
+    return distSq <= radius * radius;
+}
+
+bool Game::RectsOverlap(const SDL_FRect& a, const SDL_FRect& b)
+{
+    return !(a.x + a.w <= b.x ||
+        b.x + b.w <= a.x ||
+        a.y + a.h <= b.y ||
+        b.y + b.h <= a.y);
+}
+
+void Game::Tick(const PlayerInput& input)
+{
+    std::lock_guard<std::mutex> lock(m_levelMutex);
+
+    m_clock.Step();
+
+    Uint32 now = m_clock.NowMs();
+    float dt = static_cast<float>(m_clock.GetStepSeconds());
+
+    // Remember last positions for render interpolation
+    m_player.SavePreviousPosition();
+    m_kingPig.SavePreviousPosition();
+    for (Enemy& pig : m_minionPigs)
+        pig.SavePreviousPosition();
+
+    // Clicks gathered since the last tick trigger (or queue) attacks
+    for (int i = 0; i < input.attackPresses; ++i)
+        m_player.SetState(AnimState::Attack);
+
+    // Update door animation frames
+    {
+        ScopedTimer timer(ProfilePhase::Animation);
+        for (Door& door : m_doors)
+            door.Update();
+    }
+
+    //  PLAYER CONTROL/AI/COMBAT (when NOT teleporting)
+    if (m_travelState == DoorTravelState::None)
+    {
+        UpdatePlayerControl(input, dt, now);
+        UpdateDialogueTiming(now);
+
+        // Enemy AI only when in the enemy level
+        if (IsEnemyLevelActive())
+        {
+            UpdateMinionAI(dt);
+            UpdateKingPigAI(dt);
+        }
+        else
+        {
+            // Player elsewhere → keep pigs idle
+            for (Enemy& pig : m_minionPigs)
+                pig.SetState(EnemyAnimState::Idle);
+            m_kingPig.SetState(EnemyAnimState::Idle);
+        }
+
+        ResolvePlayerAttack();
+
+        // Update animation frames
+        UpdateAnimations();
+    }
+    else
+    {
+        //  TELEPORTING THROUGH DOOR (no control)
+        UpdateDoorTravel(now);
+
+        // Still update animations during teleport
+        UpdateAnimations();
+        m_kingPigDialogue.Update();
+    }
+
+    PrefetchDoorTargets();
+
+    // Snapshots from this tick on no longer use dropped sheets
+    SyncAssetResidency(m_clock.GetTickCount());
+}
+
+void Game::UpdatePlayerControl(const PlayerInput& input, float dt, Uint32 now)
+{
+    ScopedTimer timer(ProfilePhase::PlayerControl);
+
+    // Player movement & door interaction
+    if (m_levelDesigner.GetActiveLevel() != m_playerLevelIndex)
+        return;
+
+    if (m_player.IsDead())
+    {
+        // Dead: no movement / no door usage
+        m_fWasDown = input.door;
+        return;
+    }
+
+    float speed = 180.0f; // player move speed (pixels/s)
+
+    float dx = 0.0f;
+    float dy = 0.0f;
+
+    // WASD movement
+    if (input.left)
+        dx -= speed * dt;
+    if (input.right)
+        dx += speed * dt;
+    if (input.up)
+        dy -= speed * dt;
+    if (input.down)
+        dy += speed * dt;
+
+    if (dx != 0.0f || dy != 0.0f)
+    {
+        m_player.MoveWithCollision(dx, dy, m_levelDesigner);
+        m_player.SetState(AnimState::Run);
+    }
+    else
+    {
+        m_player.SetState(AnimState::Idle);
+    }
+
+    // Door interaction (press F near door)
+    bool fDown = input.door;
+
+    if (fDown && !m_fWasDown)
+    {
+        Door* candidateDoor = nullptr;
+        for (int door : m_levelDesigner.GetRegistry().GetDoorsIn(m_playerLevelIndex))
+        {
+            if (IsPlayerNearDoor(m_doors[door], DOOR_USE_RADIUS))
+            {
+                candidateDoor = &m_doors[door];
+                break;
+            }
+        }
+
+        if (candidateDoor)
+        {
+            m_activeDoor = candidateDoor;
+            m_travelState = DoorTravelState::GoingIn;
+            m_travelStartTime = now;
+            m_doorHeld = false;
+
+            m_activeDoor->SetState(DoorAnimState::Opening);
+            m_player.SetState(AnimState::DoorIn);
+
+            // Usually prefetched already on the way to the door
+            m_levelDesigner.PrefetchLevel(m_activeDoor->GetToLevel());
+        }
+    }
+
+    m_fWasDown = fDown;
+}
+
+void Game::UpdateDialogueTiming(Uint32 now)
+{
+    m_kingPigDialogue.Update();
+
+    // Minions start chasing 0.5s AFTER dialogue finishes
+    if (!m_minionChaseUnlocked && m_kingPigDialogueStarted && m_kingPigDialogue.IsFinished())
+    {
+        if (m_minionChaseUnlockStart == 0)
+            m_minionChaseUnlockStart = now;
+        else if (now - m_minionChaseUnlockStart >= 500) // 0.5 seconds
+            m_minionChaseUnlocked = true;
+    }
+}
+
+void Game::UpdateMinionAI(float dt)
+{
+    ScopedTimer timer(ProfilePhase::MinionAI);
+
+    for (size_t i = 0; i < m_minionPigs.size(); ++i)
+    {
+        Enemy& pig = m_minionPigs[i];
+
+        if (!m_minionChaseUnlocked)
+        {
+            if (!pig.IsDead())
+                pig.SetState(EnemyAnimState::Idle);
+            continue;
+        }
+
+        // No movement while stunned or dead
+        if (pig.IsDead() || pig.IsStunned())
+            continue;
+
+        // Centers
+        float playerCenterX = m_player.GetX() + m_player.GetWidth() * 0.5f;
+        float playerCenterY = m_player.GetY() + m_player.GetHeight() * 0.5f;
+        float pigCenterX = pig.GetX() + pig.GetWidth() * 0.5f;
+        float pigCenterY = pig.GetY() + pig.GetHeight() * 0.5f;
+
+        // Always face the player
+        pig.SetFacingRight(playerCenterX > pigCenterX);
+
+        // Melee attack range
+        const float ATTACK_RANGE = 30.0f; // distance from pig center
+        const float VERT_TOLERANCE = 16.0f; // vertical leniency
+
+        float dxAttack = playerCenterX - pigCenterX;
+        float dyAttack = playerCenterY - pigCenterY;
+        float distSqAttack = dxAttack * dxAttack + dyAttack * dyAttack;
+
+        if (distSqAttack <= ATTACK_RANGE * ATTACK_RANGE &&
+            std::abs(dyAttack) <= VERT_TOLERANCE &&
+            !m_player.IsDead())
+        {
+            // In melee range = attack animation + damage
+            pig.SetState(EnemyAnimState::Attack);
+            m_player.ApplyDamage(1);
+            continue; // skip movement this frame
+        }
+
+        // Surrounding behaviour (offset per pig index)
+        float offsetX = 0.0f;
+        float offsetY = 0.0f;
+
+        if (i == 0) offsetX = -40.0f; // left
+        if (i == 1) offsetX = 40.0f; // right
+        if (i == 2) offsetY = -40.0f; // top
+        if (i == 3) offsetY = 40.0f; // bottom
+
+        float targetX = playerCenterX + offsetX;
+        float targetY = playerCenterY + offsetY;
+
+        float dirX = targetX - pigCenterX;
+        float dirY = targetY - pigCenterY;
+        float lenSq = dirX * dirX + dirY * dirY;
+
+        if (lenSq > 1.0f)
+        {
+            float len = std::sqrt(lenSq);
+            dirX /= len;
+            dirY /= len;
+
+            float moveX = dirX * 120.0f * dt;
+            float moveY = dirY * 120.0f * dt;
+
+            pig.SetState(EnemyAnimState::Run);
+            pig.MoveWithCollision(moveX, moveY, m_levelDesigner);
+        }
+        else
+        {
+            pig.SetState(EnemyAnimState::Idle);
+        }
+    }
+}
+
+void Game::UpdateKingPigAI(float dt)
+{
+    ScopedTimer timer(ProfilePhase::KingPigAI);
+
+    // Check if any minion is dead
+    bool anyMinionDead = false;
+    for (const Enemy& pig : m_minionPigs)
+    {
+        if (pig.GetState() == EnemyAnimState::Dead)
+        {
+            anyMinionDead = true;
+            break;
+        }
+    }
+
+    // Player distance from king
+    float kingCenterX = m_kingPig.GetX() + m_kingPig.GetWidth() * 0.5f;
+    float kingCenterY = m_kingPig.GetY() + m_kingPig.GetHeight() * 0.5f;
+    float playerCenterX = m_player.GetX() + m_player.GetWidth() * 0.5f;
+    float playerCenterY = m_player.GetY() + m_player.GetHeight() * 0.5f;
+
+    float dxKing = playerCenterX - kingCenterX;
+    float dyKing = playerCenterY - kingCenterY;
+    float distSqKing = dxKing * dxKing + dyKing * dyKing;
+
+    if (!m_kingPigAwake)
+    {
+        if (anyMinionDead ||
+            distSqKing <= m_kingPigWakeRadius * m_kingPigWakeRadius)
+        {
+            m_kingPigAwake = true;
+        }
+    }
+
+    // Face toward the player
+    m_kingPig.SetFacingRight(playerCenterX > kingCenterX);
+
+    // King melee attack range
+    const float KING_ATTACK_RANGE = 50.0f;
+    const float KING_VERT_TOL = 18.0f;
+
+    float dxAttackK = playerCenterX - kingCenterX;
+    float dyAttackK = playerCenterY - kingCenterY;
+    float distSqAttackK = dxAttackK * dxAttackK + dyAttackK * dyAttackK;
+
+    if (m_kingPigAwake && !m_kingPig.IsDead() && !m_kingPig.IsStunned() && distSqAttackK <= KING_ATTACK_RANGE * KING_ATTACK_RANGE && std::abs(dyAttackK) <= KING_VERT_TOL &&
+        !m_player.IsDead())
+    {
+        m_kingPig.SetState(EnemyAnimState::Attack);
+        m_player.ApplyDamage(1);
+    }
+    else if (m_kingPigAwake && !m_kingPig.IsDead() && !m_kingPig.IsStunned())
+    {
+        // Chase the player
+        if (distSqKing > 1.0f)
+        {
+            float len = std::sqrt(distSqKing);
+            dxKing /= len;
+            dyKing /= len;
+
+            const float KING_SPEED = 95.0f;
+            float kdx = dxKing * KING_SPEED * dt;
+            float kdy = dyKing * KING_SPEED * dt;
+
+            m_kingPig.SetState(EnemyAnimState::Run);
+            m_kingPig.MoveWithCollision(kdx, kdy, m_levelDesigner);
+        }
+        else
+        {
+            m_kingPig.SetState(EnemyAnimState::Idle);
+        }
+    }
+    else if (!m_kingPig.IsDead())
+    {
+        m_kingPig.SetState(EnemyAnimState::Idle);
+    }
+}
+
+void Game::ResolvePlayerAttack()
+{
+    ScopedTimer timer(ProfilePhase::HitPass);
+
+    // Player attack vs enemies
+
+    if (!IsEnemyLevelActive() || !m_player.IsAttacking())
+        return;
+
+    SDL_FRect hitBox = m_player.GetAttackHitBox();
+    unsigned int atkId = m_player.GetAttackNumber();
+
+    // Minions
+    for (Enemy& pig : m_minionPigs)
+    {
+        if (pig.IsDead())
+            continue;
+
+        SDL_FRect pigRect{
+            pig.GetX(),
+            pig.GetY(),
+            static_cast<float>(pig.GetWidth()),
+            static_cast<float>(pig.GetHeight())
+        };
+
+        if (RectsOverlap(hitBox, pigRect))
+        {
+            pig.ApplyDamage(1, atkId); // 3 HP total
+        }
+    }
+
+    // King
+    if (!m_kingPig.IsDead())
+    {
+        SDL_FRect kingRect{
+            m_kingPig.GetX(),
+            m_kingPig.GetY(),
+            static_cast<float>(m_kingPig.GetWidth()),
+            static_cast<float>(m_kingPig.GetHeight())
+        };
+
+        if (RectsOverlap(hitBox, kingRect))
+        {
+            m_kingPig.ApplyDamage(1, atkId); // 5 HP total
+        }
+    }
+}
+
+void Game::UpdateDoorTravel(Uint32 now)
+{
+    Uint32 elapsed = now - m_travelStartTime;
+
+    if (m_travelState == DoorTravelState::GoingIn)
+    {
+        if (elapsed >= DOOR_PHASE_MS && m_activeDoor)
+        {
+            int oldLevel = m_activeDoor->GetFromLevel();
+            int newLevel = m_activeDoor->GetToLevel();
+
+            // Stay in the door until the prefetch worker has the level
+            // (asking again in case it was evicted since)
+            m_levelDesigner.PrefetchLevel(newLevel);
+            if (!m_levelDesigner.IsLevelCached(newLevel))
+            {
+                if (!m_doorHeld)
+                {
+                    m_doorHeld = true;
+                    ++m_doorPrefetchMisses;
+                    SDL_Log("Game: level %d not decoded yet, holding the door (miss %d)",
+                        newLevel + 1, m_doorPrefetchMisses);
+                }
+
+                if (m_waitForLevels)
+                    m_levelDesigner.WaitForPrefetch(newLevel);
+            }
+
+            if (!m_levelDesigner.SetActiveLevel(newLevel))
+                return;
+
+            if (m_doorHeld)
+                SDL_Log("Game: door held %u ms for level %d", elapsed - DOOR_PHASE_MS, newLevel + 1);
+
+            // Move to target level/position
+            m_playerLevelIndex = newLevel;
+
+            m_player.SetPosition(m_activeDoor->GetTargetX(),
+                m_activeDoor->GetTargetY());
+            m_player.SetState(AnimState::DoorOut);
+
+            // Start King dialogue the first time we enter the enemy level
+            if (newLevel == m_levelDesigner.GetRegistry().GetEnemyLevel() && !m_kingPigDialogueStarted)
+            {
+                m_kingPigDialogue.Start();
+                m_kingPigDialogueStarted = true;
+            }
+
+            // Come out of the door leading back (none = one-way door)
+            int exitDoor = m_levelDesigner.GetRegistry().FindDoor(newLevel, oldLevel);
+            m_activeDoor = (exitDoor >= 0) ? &m_doors[exitDoor] : nullptr;
+
+            if (m_activeDoor)
+                m_activeDoor->SetState(DoorAnimState::Opening);
+
+            m_travelState = DoorTravelState::ComingOut;
+            m_travelStartTime = now;
+        }
+    }
+    else if (m_travelState == DoorTravelState::ComingOut)
+    {
+        if (elapsed >= DOOR_PHASE_MS)
+        {
+            if (m_activeDoor)
+                m_activeDoor->SetState(DoorAnimState::Closing);
+
+            m_player.SetState(AnimState::Idle);
+            m_travelState = DoorTravelState::None;
+            m_activeDoor = nullptr;
+        }
+    }
+}
+
+void Game::UpdateAnimations()
+{
+    ScopedTimer timer(ProfilePhase::Animation);
+
+    m_player.Update();
+    m_kingPig.Update();
+    for (Enemy& pig : m_minionPigs)
+        pig.Update();
+}
+
+void Game::BuildSnapshot(RenderSnapshot& snapshot)
+{
+    std::lock_guard<std::mutex> lock(m_levelMutex);
+
+    snapshot.sprites.Begin();
+    QueueEntitySprites(snapshot.sprites);
+    QueueUISprites(snapshot.sprites);
+    snapshot.sprites.Sort();
+
+    snapshot.level = m_levelDesigner.GetActiveLevelRef();
+    snapshot.worldWidth = m_levelDesigner.GetWorldWidth();
+    snapshot.worldHeight = m_levelDesigner.GetWorldHeight();
+
+    float halfW = m_player.GetWidth() * 0.5f;
+    float halfH = m_player.GetHeight() * 0.5f;
+    snapshot.focusPrevX = m_player.GetRenderX(0.0f) + halfW;
+    snapshot.focusPrevY = m_player.GetRenderY(0.0f) + halfH;
+    snapshot.focusX = m_player.GetX() + halfW;
+    snapshot.focusY = m_player.GetY() + halfH;
+}
+
+void Game::Render(SDL_Renderer* renderer, RenderSnapshot& snapshot, float alpha)
+{
+    if (!renderer)
+        return;
+
+    // Upload sheets of levels we're entering, free those we've left
+    TextureAtlas::Instance().UpdateResidency(renderer, snapshot.tick);
+
+    SDL_SetRenderDrawColor(renderer, 30, 30, 30, 255);
+    SDL_RenderClear(renderer);
+
+    // Camera follows the interpolated player
+    int screenW = 0, screenH = 0;
+    SDL_GetRendererOutputSize(renderer, &screenW, &screenH);
+    m_camera.SetViewSize(screenW, screenH);
+    m_camera.SetWorldSize(snapshot.worldWidth, snapshot.worldHeight);
+    m_camera.CenterOn(
+        snapshot.focusPrevX + (snapshot.focusX - snapshot.focusPrevX) * alpha,
+        snapshot.focusPrevY + (snapshot.focusY - snapshot.focusPrevY) * alpha);
+
+    const SDL_Rect& view = m_camera.GetView();
+
+    // Tiles of the snapshot's level: no level lock, so a slow frame
+    // (chunk caches rebuilt after a level switch) never stalls the sim
+    {
+        ScopedTimer timer(ProfilePhase::LevelRender);
+        m_levelDesigner.Render(renderer, snapshot.level, m_camera);
+    }
+
+    // Doors, pigs, player, bubbles: already sorted, drawn in a few calls
+    {
+        ScopedTimer entityTimer(ProfilePhase::EntityRender);
+        snapshot.sprites.Flush(renderer, alpha, view, SpriteLayer::Props, SpriteLayer::Effects);
+    }
+
+    // Decoration in front of the characters, editor grid
+    {
+        ScopedTimer timer(ProfilePhase::LevelRender);
+        m_levelDesigner.RenderForeground(renderer, snapshot.level, m_camera);
+    }
+
+    // UI stays in screen space
+    SDL_Rect screen{ 0, 0, screenW, screenH };
+    snapshot.sprites.Flush(renderer, alpha, screen, SpriteLayer::UI, SpriteLayer::UI);
+}
+
+void Game::QueueEntitySprites(SpriteBatch& batch) const
+{
+    for (int door : m_levelDesigner.GetRegistry().GetDoorsIn(m_levelDesigner.GetActiveLevel()))
+        m_doors[door].Render(batch);
+
+    if (IsEnemyLevelActive())
+    {
+        // Minion pigs
+        for (const Enemy& pig : m_minionPigs)
+            pig.Render(batch);
+
+        // King Pig
+        m_kingPig.Render(batch);
+
+        // Dialogue bubbles over King
+        if (m_kingPigDialogue.IsPlaying())
+            m_kingPigDialogue.Render(batch,
+                m_kingPig.GetRenderX(0.0f), m_kingPig.GetRenderY(0.0f),
+                m_kingPig.GetX(), m_kingPig.GetY());
+    }
+
+    // Draw player only in the active level
+    if (m_levelDesigner.GetActiveLevel() == m_playerLevelIndex)
+        m_player.Render(batch);
+}
+
+void Game::QueueUISprites(SpriteBatch& batch) const
+{
+    // UI: life bar
+    int hearts = m_player.GetHealth();
+    hearts = std::max(0, std::min(hearts, m_player.GetMaxHealth()));
+
+    AtlasRegion liveBar = TextureAtlas::Instance().GetRegion(m_liveBarSprite);
+
+    if (hearts > 0 && liveBar.texture)
+    {
+        SDL_Rect src;
+        src.x = liveBar.rect.x;
+        src.y = liveBar.rect.y;
+        src.w = HEART_W * hearts;
+        src.h = LIVE_BAR_H;
+
+        SDL_FRect dst;
+        dst.x = 16.0f;
+        dst.y = 16.0f;
+        dst.w = static_cast<float>(src.w * 2);
+        dst.h = static_cast<float>(src.h * 2);
+
+        batch.Draw(liveBar.texture, src, dst, SDL_FLIP_NONE, SpriteLayer::UI, 0.0f);
+    }
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <SDL.h>
+#include <mutex>
+#include <vector>
+
+#include "LevelDesigner.h"
+#include "Character.h"
+#include "Door.h"
+#include "Enemy.h"
+#include "DialogueBox.h"
+#include "Camera.h"
+#include "GameClock.h"
+#include "SpriteBatch.h"
+
+struct RenderSnapshot;
+
+// Teleport state when using doors
+enum class DoorTravelState
+{
+    None,
+    GoingIn,
+    ComingOut
+};
+
+// Everything the simulation reads from the player for one tick
+struct PlayerInput
+{
+    bool left = false;
+    bool right = false;
+    bool up = false;
+    bool down = false;
+    bool door = false;      // F held
+    int  attackPresses = 0; // left clicks since the last tick
+};
+
+// Whole game world: level, player, doors, pigs, dialogue + UI.
+// Works with or without a renderer (nullptr = headless simulation).
+class Game
+{
+public:
+    Game();
+    ~Game();
+
+    // Sets up the world and starts decoding sprite sheets on worker
+    // threads; call FinishLoading() (main thread) before rendering
+    bool Init(SDL_Renderer* renderer);
+
+    // Loading screen: decode progress 0..1, done = ready to upload
+    float GetLoadingProgress() const;
+    bool  IsLoadingDone() const;
+    bool  FinishLoading(SDL_Renderer* renderer);
+
+    // Editor input (paint mode, F1/F2 level switch)
+    void HandleEvent(const SDL_Event& e);
+
+    // One fixed simulation step (advances the game clock by one tick)
+    void Tick(const PlayerInput& input);
+
+    // Door travel normally holds the player in the door until the
+    // prefetch worker has decoded the target level, however many ticks
+    // that takes. Recordings and replays need the same ticks every run:
+    // with wait = true the sim thread waits for the worker instead.
+    void SetWaitForLevels(bool wait) { m_waitForLevels = wait; }
+
+    // Capture everything drawn this tick (sim side). Safe to call while
+    // another thread renders an older snapshot.
+    void BuildSnapshot(RenderSnapshot& snapshot);
+
+    // Draw a snapshot (render side); alpha = 0..1 blend between its
+    // previous and current sim state
+    void Render(SDL_Renderer* renderer, RenderSnapshot& snapshot, float alpha);
+
+    // Sim time: the loop feeds real time, pauses or scales it
+    GameClock&       GetClock()       { return m_clock; }
+    const GameClock& GetClock() const { return m_clock; }
+
+    // Read-only access for summaries/debugging
+    const Character& GetPlayer() const { return m_player; }
+    int GetPlayerLevel() const { return m_playerLevelIndex; }
+    int GetDeadPigCount() const;
+    bool IsKingPigDead() const { return m_kingPig.IsDead(); }
+    DoorTravelState GetTravelState() const { return m_travelState; }
+
+    // Door uses whose target level wasn't decoded at the end of GoingIn
+    int GetDoorPrefetchMisses() const { return m_doorPrefetchMisses; }
+
+    // Hash of the gameplay-relevant world state (positions, health,
+    // anim states, door travel, levels) used to verify replays
+    Uint32 HashState() const;
+
+private:
+    // Tick phases
+    void UpdatePlayerControl(const PlayerInput& input, float dt, Uint32 now);
+    void UpdateDialogueTiming(Uint32 now);
+    void UpdateMinionAI(float dt);
+    void UpdateKingPigAI(float dt);
+    void ResolvePlayerAttack();
+    void UpdateDoorTravel(Uint32 now);
+    void UpdateAnimations();
+
+    // Snapshot passes (level layers are drawn around the entity sprites)
+    void QueueEntitySprites(SpriteBatch& batch) const;
+    void QueueUISprites(SpriteBatch& batch) const;
+
+    // Tell the TextureAtlas which level groups to keep resident (levels
+    // in the LevelDesigner cache + door target while going in). Level
+    // lock held.
+    void SyncAssetResidency(Uint64 releaseTick);
+
+    // Player close to a door (or walking into one): decode the level
+    // behind it and its sprite sheets in the background, so the switch
+    // at the end of GoingIn doesn't wait on the disk. Level lock held.
+    void PrefetchDoorTargets();
+
+    // Helper: the level shown is the one the pigs live in
+    bool IsEnemyLevelActive() const
+    {
+        return m_levelDesigner.GetActiveLevel() == m_levelDesigner.GetRegistry().GetEnemyLevel();
+    }
+
+    // Helper: check if player is within radius of a door
+    bool IsPlayerNearDoor(const Door& d, float radius) const;
+
+    // Helper: simple AABB overlap
+    static bool RectsOverlap(const SDL_FRect& a, const SDL_FRect& b);
+
+    // Single time source shared by every entity
+    GameClock m_clock;
+
+    // Guards the level grid + active level: the sim thread ticks
+    // (collision, door travel) while the main thread edits. Rendering
+    // draws the snapshot's level and doesn't take it.
+    mutable std::mutex m_levelMutex;
+
+    // Follows the player; only touched on the main (render/input) thread
+    Camera m_camera;
+
+    LevelDesigner m_levelDesigner;
+    Character     m_player;
+    int           m_playerLevelIndex = 0; // level id from the manifest (0 = level1)
+
+    // Doors (tunnels between levels), one per LevelRegistry door link
+    // and in the same order
+    std::vector<Door> m_doors;
+
+    // Enemies
+    Enemy              m_kingPig;
+    std::vector<Enemy> m_minionPigs;
+
+    // UI: life bar (TextureAtlas sprite id)
+    int m_liveBarSprite = -1;
+
+    // King Pig dialogue
+    DialogueBox m_kingPigDialogue;
+
+    bool   m_kingPigDialogueStarted = false;
+    bool   m_minionChaseUnlocked = false;   // minions wait for dialogue
+    Uint32 m_minionChaseUnlockStart = 0;    // when we started 0.5s timer
+
+    // King Pig wake-up when minion dies or player gets close
+    bool  m_kingPigAwake = false;
+    float m_kingPigWakeRadius = 220.0f; // radius from king center
+
+    // Teleport state
+    DoorTravelState m_travelState = DoorTravelState::None;
+    Uint32          m_travelStartTime = 0;
+    Door*           m_activeDoor = nullptr;
+
+    // Level PrefetchDoorTargets() asked for, -1 = none
+    int m_prefetchLevel = -1;
+
+    bool m_waitForLevels = false;   // see SetWaitForLevels()
+    bool m_doorHeld = false;        // current travel waits for its level
+    int  m_doorPrefetchMisses = 0;
+
+    // Last groups passed to TextureAtlas::SetWantedGroups()
+    std::vector<int> m_wantedAtlasGroups;
+    std::vector<int> m_cachedLevels;   // scratch for SyncAssetResidency()
+
+    bool m_fWasDown = false; // for detecting fresh F press
+};
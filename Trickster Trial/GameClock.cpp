@@ -0,0 +1,53 @@
+#include "GameClock.h"
+#include <cmath>
+
+namespace
+{
+    const double MIN_TIME_SCALE = 0.125;
+    const double MAX_TIME_SCALE = 16.0;
+}
+
+GameClock::GameClock(double stepSeconds)
+    : m_stepSeconds(stepSeconds)
+{
+}
+
+void GameClock::AddRealTime(double realSeconds)
+{
+    if (m_paused || realSeconds <= 0.0)
+        return;
+
+    m_accumulator += realSeconds * m_timeScale;
+}
+
+bool GameClock::ConsumeStep()
+{
+    if (m_accumulator < m_stepSeconds)
+        return false;
+
+    m_accumulator -= m_stepSeconds;
+    return true;
+}
+
+void GameClock::DiscardBacklog()
+{
+    m_accumulator = std::fmod(m_accumulator, m_stepSeconds);
+}
+
+Uint32 GameClock::NowMs() const
+{
+    // Derived from the tick count so it is identical on every run
+    return static_cast<Uint32>(static_cast<double>(m_tickCount) * m_stepSeconds * 1000.0);
+}
+
+float GameClock::GetAlpha() const
+{
+    return static_cast<float>(m_accumulator / m_stepSeconds);
+}
+
+void GameClock::SetTimeScale(double scale)
+{
+    if (scale < MIN_TIME_SCALE) scale = MIN_TIME_SCALE;
+    if (scale > MAX_TIME_SCALE) scale = MAX_TIME_SCALE;
+    m_timeScale = scale;
+}
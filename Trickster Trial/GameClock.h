@@ -0,0 +1,48 @@
+#pragma once
+
+#include <SDL.h>
+
+// Simulation time. The game loop feeds it real time and steps it in
+// fixed ticks; every entity reads NowMs() instead of SDL_GetTicks(),
+// so timers follow sim time (pause, slow-mo, fast-forward, headless).
+class GameClock
+{
+public:
+    explicit GameClock(double stepSeconds = 1.0 / 120.0);
+
+    // Bank real elapsed time (seconds), after pause/time scale
+    void AddRealTime(double realSeconds);
+
+    // True (and removes one step from the bank) if a tick is due
+    bool ConsumeStep();
+
+    // Drop whole steps still banked (sim can't keep up), keep the
+    // fraction for interpolation
+    void DiscardBacklog();
+
+    // Advance sim time by exactly one fixed step
+    void Step() { ++m_tickCount; }
+
+    // Sim time in ms since start (what timers compare against)
+    Uint32 NowMs() const;
+
+    Uint64 GetTickCount()    const { return m_tickCount; }
+    double GetStepSeconds()  const { return m_stepSeconds; }
+
+    // 0..1 position between the last two ticks (render interpolation)
+    float GetAlpha() const;
+
+    // Pause / time scale (1 = real time, 2 = double speed, ...)
+    void   SetPaused(bool paused) { m_paused = paused; }
+    bool   IsPaused() const { return m_paused; }
+    void   SetTimeScale(double scale);
+    double GetTimeScale() const { return m_timeScale; }
+
+private:
+    double m_stepSeconds;
+    Uint64 m_tickCount = 0;
+
+    double m_accumulator = 0.0; // banked sim time not yet stepped
+    bool   m_paused = false;
+    double m_timeScale = 1.0;
+};
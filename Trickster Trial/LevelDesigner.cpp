@@ -1,63 +1,130 @@
 ﻿#include "LevelDesigner.h"
+#include "Camera.h"
+#include "AssetArchive.h"
+#include "ByteIO.h"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <sstream>
 
+// Binary level file (little endian):
+//   header  "TTLV", version, cols, rows, layer count (5 x 4 bytes)
+//   cells   per layer, row-major
+//             version 1: filled, tileX, tileY, 0 (1 byte each)
+//             version 2: 16-bit tile id (see LevelDesigner::TileId)
+namespace
+{
+    const char   LEVEL_MAGIC[4] = { 'T', 'T', 'L', 'V' };
+    const Uint32 LEVEL_VERSION = 2;
+    const size_t LEVEL_HEADER_SIZE = 5 * 4;
+    const size_t LEVEL_CELL_SIZE_V1 = 4;
+    const size_t LEVEL_CELL_SIZE = 2;
+    const Uint32 LEVEL_MAX_LAYERS = 16;   // sanity limit, newer files may add layers
+}
+
+const LevelDesigner::TileId LevelDesigner::EMPTY_TILE;
+const size_t LevelDesigner::JOURNAL_COMPACT_RECORDS;
+const size_t LevelDesigner::DEFAULT_CACHE_BUDGET;
 
 LevelDesigner::LevelDesigner()
 {
-    // Level 0 = level1.map, Level 1 = level2.map
-    m_levelPaths[0] = "assets/levels/level1.map";
-    m_levelPaths[1] = "assets/levels/level2.map";
+    // Built-in levels until Init() reads the manifest. The first level
+    // exists right away so tools can load/resize without Init().
+    m_levels.resize(m_registry.GetLevelCount());
     m_activeLevelIndex = 0; // start on level 1
+    m_level = &CreateLevel(m_activeLevelIndex);
+    TouchLevel(*m_level);
 }
 
 LevelDesigner::~LevelDesigner()
 {
-    SaveCurrentLevel();   // save whichever level is active
-
-    if (m_tileset)
+    if (m_prefetchThread.joinable())
     {
-        SDL_DestroyTexture(m_tileset);
-        m_tileset = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_prefetchMutex);
+            m_prefetchQuit = true;
+        }
+        m_prefetchWake.notify_all();
+        m_prefetchThread.join();
     }
+
+    if (autoSaveEnabled)
+        SaveModifiedLevels();
+
+    for (LayerCache& cache : m_layerCache)
+        for (ChunkCache& chunk : cache.chunks)
+            ReleaseChunk(chunk);
 }
 
 bool LevelDesigner::Init(SDL_Renderer* renderer)
 {
     auto& texMgr = TextureManager::Instance();
 
-    m_tileset = texMgr.LoadTexture("assets/textures/Terrain.png", renderer);
-    if (!m_tileset)
+    // Headless runs only need the grid (collision), not the tileset
+    if (renderer)
     {
-        SDL_Log("LevelDesigner: failed to load tileset");
-        return false;
+        m_tileset = texMgr.LoadTexture("assets/textures/Terrain.png", renderer);
+        if (!m_tileset)
+        {
+            SDL_Log("LevelDesigner: failed to load tileset");
+            return false;
+        }
+
+        SDL_QueryTexture(m_tileset.get(), nullptr, nullptr, &m_tilesetW, &m_tilesetH);
+
+        // Chunk caches need render targets; otherwise tiles are drawn directly
+        m_useChunkTargets = SDL_RenderTargetSupported(renderer) == SDL_TRUE;
+        if (!m_useChunkTargets)
+            SDL_Log("LevelDesigner: no render targets, drawing tiles directly");
     }
 
     m_selectedTileX = 0;
     m_selectedTileY = 0;
 
-    // Try to load the currently active level.
-    LoadCurrentLevel();   // if file doesn't exist yet, just logs and starts empty
+    // Collision needs the tile table even headless
+    m_tileProperties.LoadFromFile("assets/textures/Terrain.tiles");
+    RebuildSolidMask();
+
+    // Levels + doors (the built-in pair without a manifest)
+    if (m_registry.LoadFromFile(LevelRegistry::DEFAULT_PATH) && m_registry.GetCacheBudgetBytes() > 0)
+        m_cacheBudget = m_registry.GetCacheBudgetBytes();
+    m_levels.resize(m_registry.GetLevelCount());
+
+    // Only the starting level is decoded here; the others are read the
+    // first time they're entered and then stay cached (see EvictLevels())
+    LoadLevel(m_activeLevelIndex);   // if file doesn't exist yet, just logs and starts empty
 
     return true;
 }
 
-void LevelDesigner::HandleEvent(const SDL_Event& e)
+void LevelDesigner::HandleEvent(const SDL_Event& e, const Camera& camera)
 {
+    // Render targets lose their contents on some device events
+    if (e.type == SDL_RENDER_TARGETS_RESET)
+        ResetCaches();
+
     // This lets the rest of your game still use mouse/keyboard.
     if (!paintingEnabled)
         return;
 
     if (e.type == SDL_MOUSEBUTTONDOWN)
     {
+        SDL_Point world = camera.ScreenToWorld(e.button.x, e.button.y);
+
+        // Everything painted until the button goes up is one undo step
+        if (e.button.button == SDL_BUTTON_LEFT || e.button.button == SDL_BUTTON_RIGHT)
+            m_level->journal.BeginStroke();
+
         if (e.button.button == SDL_BUTTON_LEFT)
         {
             m_isPainting = true;
-            ApplyBrush(e.button.x, e.button.y, false); // paint once on click
+            ApplyBrush(world.x, world.y, false); // paint once on click
         }
         else if (e.button.button == SDL_BUTTON_RIGHT)
         {
             m_isErasing = true;
-            ApplyBrush(e.button.x, e.button.y, true);  // erase once on click
+            ApplyBrush(world.x, world.y, true);  // erase once on click
         }
     }
 
@@ -67,22 +134,43 @@ void LevelDesigner::HandleEvent(const SDL_Event& e)
             m_isPainting = false;
         else if (e.button.button == SDL_BUTTON_RIGHT)
             m_isErasing = false;
+
+        // Stroke finished: save it in the background
+        if (autoSaveEnabled)
+            SaveCurrentLevel();
     }
 
     if (e.type == SDL_MOUSEMOTION)
     {
+        SDL_Point world = camera.ScreenToWorld(e.motion.x, e.motion.y);
+
         if (m_isPainting)
         {
-            ApplyBrush(e.motion.x, e.motion.y, false);
+            ApplyBrush(world.x, world.y, false);
         }
         else if (m_isErasing)
         {
-            ApplyBrush(e.motion.x, e.motion.y, true);
+            ApplyBrush(world.x, world.y, true);
         }
     }
 
     if (e.type == SDL_KEYDOWN)
     {
+        // Undo / redo (before the brush keys: Y picks a tile too)
+        if (e.key.keysym.mod & KMOD_CTRL)
+        {
+            bool redo = e.key.keysym.sym == SDLK_y ||
+                (e.key.keysym.sym == SDLK_z && (e.key.keysym.mod & KMOD_SHIFT));
+
+            if (redo || e.key.keysym.sym == SDLK_z)
+            {
+                bool changed = redo ? Redo() : Undo();
+                if (changed && autoSaveEnabled)
+                    SaveCurrentLevel();
+                return;
+            }
+        }
+
         switch (e.key.keysym.sym)
         {
         case SDLK_0:  m_selectedTileX = 0; m_selectedTileY = 0; break;
@@ -106,13 +194,35 @@ void LevelDesigner::HandleEvent(const SDL_Event& e)
         case SDLK_i:  m_selectedTileX = 1; m_selectedTileY = 8; break; 
         case SDLK_o:  m_selectedTileX = 1; m_selectedTileY = 7; break; 
 
+        // Previous / next level
         case SDLK_F1:
-            SetActiveLevel(0);  // level 1
-            break;
-
         case SDLK_F2:
-            SetActiveLevel(1);  // level 2
+        {
+            int next = m_activeLevelIndex + (e.key.keysym.sym == SDLK_F1 ? -1 : 1);
+            if (next < 0 || next >= GetLevelCount())
+                break;
+
+            if (autoSaveEnabled)
+                SaveCurrentLevel();
+
+            // Explicit key press: decode on the worker and wait for it
+            if (!SetActiveLevel(next))
+            {
+                PrefetchLevel(next);
+                WaitForPrefetch(next);
+                SetActiveLevel(next);
+            }
             break;
+        }
+
+        // Brush layer
+        case SDLK_F5: m_activeLayer = TileLayer::Background; SDL_Log("Brush layer: background"); break;
+        case SDLK_F6: m_activeLayer = TileLayer::Terrain;    SDL_Log("Brush layer: terrain");    break;
+        case SDLK_F7: m_activeLayer = TileLayer::Foreground; SDL_Log("Brush layer: foreground"); break;
+
+        // Grow the level by one screen (right / down)
+        case SDLK_F8: Resize(m_level->cols + DEFAULT_GRID_COLS, m_level->rows); SDL_Log("Level size: %dx%d", m_level->cols, m_level->rows); break;
+        case SDLK_F9: Resize(m_level->cols, m_level->rows + DEFAULT_GRID_ROWS); SDL_Log("Level size: %dx%d", m_level->cols, m_level->rows); break;
 
         }
 
@@ -121,53 +231,403 @@ void LevelDesigner::HandleEvent(const SDL_Event& e)
 }
 
 
-void LevelDesigner::Render(SDL_Renderer* renderer)
+void LevelDesigner::Render(SDL_Renderer* renderer, const LevelRef& level, const Camera& camera)
 {
-    auto& texMgr = TextureManager::Instance();
+    if (!level)
+        return;
+
+    // Another level since the caches were built (or they were dropped)
+    if (m_cachedLevel != level)
+        ResetCaches(level);
+
+    RenderLayer(renderer, TileLayer::Background, camera.GetView());
+    RenderLayer(renderer, TileLayer::Terrain, camera.GetView());
+}
+
+void LevelDesigner::RenderForeground(SDL_Renderer* renderer, const LevelRef& level, const Camera& camera)
+{
+    if (!level)
+        return;
+
+    if (m_cachedLevel != level)
+        ResetCaches(level);
+
+    RenderLayer(renderer, TileLayer::Foreground, camera.GetView());
+
+    // Grid lines on top, only while editing
+    if (paintingEnabled)
+    {
+        BuildGridLines(camera.GetView());
+
+        if (!m_gridLinePoints.empty())
+        {
+            SDL_SetRenderDrawColor(renderer, 80, 80, 80, 255);
+            SDL_RenderDrawLines(renderer, m_gridLinePoints.data(), static_cast<int>(m_gridLinePoints.size()));
+        }
+    }
+}
+
+SDL_Rect LevelDesigner::VisibleCells(const Level& level, const SDL_Rect& view)
+{
+    int col0 = std::max(0, view.x / TILE_SIZE_SCREEN);
+    int row0 = std::max(0, view.y / TILE_SIZE_SCREEN);
+    int col1 = std::min(level.cols, (view.x + view.w + TILE_SIZE_SCREEN - 1) / TILE_SIZE_SCREEN);
+    int row1 = std::min(level.rows, (view.y + view.h + TILE_SIZE_SCREEN - 1) / TILE_SIZE_SCREEN);
+
+    return SDL_Rect{ col0, row0, std::max(0, col1 - col0), std::max(0, row1 - row0) };
+}
+
+void LevelDesigner::RenderLayer(SDL_Renderer* renderer, TileLayer layer, const SDL_Rect& view)
+{
+    if (!m_tileset)
+        return;
+
+    if (!m_useChunkTargets)
+    {
+        // Straight from the grid: cost follows the visible cells only
+        BuildMesh(*m_cachedLevel, layer, VisibleCells(*m_cachedLevel, view), view.x, view.y);
+        if (!m_indices.empty())
+        {
+            SDL_RenderGeometry(renderer, m_tileset.get(),
+                m_vertices.data(), static_cast<int>(m_vertices.size()),
+                m_indices.data(), static_cast<int>(m_indices.size()));
+        }
+        return;
+    }
+
+    LayerCache& cache = m_layerCache[static_cast<int>(layer)];
+
+    int chunkCol0 = std::max(0, view.x / CHUNK_SIZE_SCREEN);
+    int chunkRow0 = std::max(0, view.y / CHUNK_SIZE_SCREEN);
+    int chunkCol1 = std::min(m_chunkCols - 1, (view.x + view.w - 1) / CHUNK_SIZE_SCREEN);
+    int chunkRow1 = std::min(m_chunkRows - 1, (view.y + view.h - 1) / CHUNK_SIZE_SCREEN);
+
+    // Chunks more than one chunk off screen give their texture back
+    for (size_t i = 0; i < cache.resident.size();)
+    {
+        int index = cache.resident[i];
+        int chunkCol = index % m_chunkCols;
+        int chunkRow = index / m_chunkCols;
+
+        if (chunkCol < chunkCol0 - 1 || chunkCol > chunkCol1 + 1 ||
+            chunkRow < chunkRow0 - 1 || chunkRow > chunkRow1 + 1)
+        {
+            ReleaseChunk(cache.chunks[index]);
+            cache.resident[i] = cache.resident.back();
+            cache.resident.pop_back();
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    // Steady state: one quad per visible chunk
+    for (int chunkRow = chunkRow0; chunkRow <= chunkRow1; ++chunkRow)
+    {
+        for (int chunkCol = chunkCol0; chunkCol <= chunkCol1; ++chunkCol)
+        {
+            int index = chunkRow * m_chunkCols + chunkCol;
+            ChunkCache& chunk = cache.chunks[index];
+
+            if (chunk.dirty.w > 0 || (!chunk.target && !chunk.empty))
+                UpdateChunk(renderer, layer, index);
+
+            if (!chunk.target)
+                continue;
+
+            SDL_Rect dst{
+                chunkCol * CHUNK_SIZE_SCREEN - view.x, chunkRow * CHUNK_SIZE_SCREEN - view.y,
+                CHUNK_SIZE_SCREEN, CHUNK_SIZE_SCREEN };
+            SDL_RenderCopy(renderer, chunk.target, nullptr, &dst);
+        }
+    }
+}
+
+void LevelDesigner::UpdateChunk(SDL_Renderer* renderer, TileLayer layer, int chunkIndex)
+{
+    LayerCache& cache = m_layerCache[static_cast<int>(layer)];
+    ChunkCache& chunk = cache.chunks[chunkIndex];
+
+    int chunkCol = chunkIndex % m_chunkCols;
+    int chunkRow = chunkIndex / m_chunkCols;
+
+    const Level& level = *m_cachedLevel;
+    const int chunkCells1D = CHUNK_CELLS;
+    SDL_Rect chunkCells{ chunkCol * CHUNK_CELLS, chunkRow * CHUNK_CELLS,
+        std::min(chunkCells1D, level.cols - chunkCol * CHUNK_CELLS),
+        std::min(chunkCells1D, level.rows - chunkRow * CHUNK_CELLS) };
+
+    // A chunk without texture has to be drawn whole
+    SDL_Rect cells = chunk.target ? chunk.dirty : chunkCells;
+    chunk.dirty = SDL_Rect{ 0, 0, 0, 0 };
+
+    int originX = chunkCells.x * TILE_SIZE_SCREEN;
+    int originY = chunkCells.y * TILE_SIZE_SCREEN;
+    BuildMesh(level, layer, cells, originX, originY);
+
+    bool whole = cells.x == chunkCells.x && cells.y == chunkCells.y &&
+        cells.w == chunkCells.w && cells.h == chunkCells.h;
+
+    // Nothing painted in this chunk: no texture needed
+    if (whole && m_indices.empty())
+    {
+        if (chunk.target)
+        {
+            ReleaseChunk(chunk);
+            cache.resident.erase(std::find(cache.resident.begin(), cache.resident.end(), chunkIndex));
+        }
+        chunk.empty = true;
+        return;
+    }
+
+    chunk.empty = false;
+
+    if (!chunk.target)
+    {
+        chunk.target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+            CHUNK_SIZE_SCREEN, CHUNK_SIZE_SCREEN);
+        if (!chunk.target)
+        {
+            SDL_Log("LevelDesigner: chunk cache failed (%s), drawing tiles directly", SDL_GetError());
+            m_useChunkTargets = false;
+            return;
+        }
+
+        SDL_SetTextureBlendMode(chunk.target, SDL_BLENDMODE_BLEND);
+        cache.resident.push_back(chunkIndex);
+    }
+
+    SDL_Rect pixels{
+        cells.x * TILE_SIZE_SCREEN - originX, cells.y * TILE_SIZE_SCREEN - originY,
+        cells.w * TILE_SIZE_SCREEN, cells.h * TILE_SIZE_SCREEN };
+
+    // A fresh texture is undefined outside the tiles: clear all of it
+    if (whole)
+        pixels = SDL_Rect{ 0, 0, CHUNK_SIZE_SCREEN, CHUNK_SIZE_SCREEN };
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    SDL_BlendMode previousBlend = SDL_BLENDMODE_NONE;
+    SDL_GetRenderDrawBlendMode(renderer, &previousBlend);
+
+    SDL_SetRenderTarget(renderer, chunk.target);
+
+    // Cells never overlap inside a layer, so tiles (alpha included) are
+    // copied over the cleared area instead of blended
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderFillRect(renderer, &pixels);
+
+    if (!m_indices.empty())
+    {
+        SDL_SetTextureBlendMode(m_tileset.get(), SDL_BLENDMODE_NONE);
+        SDL_RenderGeometry(renderer, m_tileset.get(),
+            m_vertices.data(), static_cast<int>(m_vertices.size()),
+            m_indices.data(), static_cast<int>(m_indices.size()));
+        SDL_SetTextureBlendMode(m_tileset.get(), SDL_BLENDMODE_BLEND);
+    }
 
-    // Draw all tiles
-    for (int row = 0; row < GRID_ROWS; ++row)
+    SDL_SetRenderTarget(renderer, previousTarget);
+    SDL_SetRenderDrawBlendMode(renderer, previousBlend);
+}
+
+void LevelDesigner::BuildMesh(const Level& level, TileLayer layer, const SDL_Rect& cells, int originX, int originY)
+{
+    m_vertices.clear();
+    m_indices.clear();
+
+    if (m_tilesetW <= 0 || m_tilesetH <= 0)
+        return;
+
+    const SDL_Color white{ 255, 255, 255, 255 };
+    const float du = static_cast<float>(TILE_SIZE_SHEET) / m_tilesetW;
+    const float dv = static_cast<float>(TILE_SIZE_SHEET) / m_tilesetH;
+
+    const int endCol = cells.x + cells.w;
+
+    for (int row = cells.y; row < cells.y + cells.h; ++row)
+    {
+        // Walk the row one storage chunk at a time; unpainted chunks are skipped whole
+        for (int col = cells.x; col < endCol; )
+        {
+            const int segmentEnd = std::min(endCol, (col | TILE_CHUNK_MASK) + 1);
+            const TileChunk* chunk = TileChunkAt(level, layer, col, row);
+            if (!chunk)
+            {
+                col = segmentEnd;
+                continue;
+            }
+
+            const TileId* tiles = chunk->tiles + (row & TILE_CHUNK_MASK) * TILE_CHUNK_CELLS;
+            for (; col < segmentEnd; ++col)
+            {
+                TileId id = tiles[col & TILE_CHUNK_MASK];
+                if (id == EMPTY_TILE)
+                    continue;
+
+                float x0 = static_cast<float>(col * TILE_SIZE_SCREEN - originX);
+                float y0 = static_cast<float>(row * TILE_SIZE_SCREEN - originY);
+                float x1 = x0 + TILE_SIZE_SCREEN;
+                float y1 = y0 + TILE_SIZE_SCREEN;
+
+                float u0 = TileIdX(id) * du;
+                float v0 = TileIdY(id) * dv;
+                float u1 = u0 + du;
+                float v1 = v0 + dv;
+
+                int base = static_cast<int>(m_vertices.size());
+
+                m_vertices.push_back(SDL_Vertex{ SDL_FPoint{ x0, y0 }, white, SDL_FPoint{ u0, v0 } });
+                m_vertices.push_back(SDL_Vertex{ SDL_FPoint{ x1, y0 }, white, SDL_FPoint{ u1, v0 } });
+                m_vertices.push_back(SDL_Vertex{ SDL_FPoint{ x1, y1 }, white, SDL_FPoint{ u1, v1 } });
+                m_vertices.push_back(SDL_Vertex{ SDL_FPoint{ x0, y1 }, white, SDL_FPoint{ u0, v1 } });
+
+                const int quad[6] = { 0, 1, 2, 0, 2, 3 };
+                for (int i : quad)
+                    m_indices.push_back(base + i);
+            }
+        }
+    }
+}
+
+void LevelDesigner::ReleaseChunk(ChunkCache& chunk)
+{
+    if (chunk.target)
+    {
+        SDL_DestroyTexture(chunk.target);
+        chunk.target = nullptr;
+    }
+    chunk.dirty = SDL_Rect{ 0, 0, 0, 0 }; // redrawn whole when it comes back
+}
+
+void LevelDesigner::ResetCaches(const LevelRef& level)
+{
+    m_cachedLevel = level;
+    m_chunkCols = level ? (level->cols + CHUNK_CELLS - 1) / CHUNK_CELLS : 0;
+    m_chunkRows = level ? (level->rows + CHUNK_CELLS - 1) / CHUNK_CELLS : 0;
+
+    for (LayerCache& cache : m_layerCache)
     {
-        for (int col = 0; col < GRID_COLS; ++col)
+        for (ChunkCache& chunk : cache.chunks)
+            ReleaseChunk(chunk);
+
+        cache.chunks.assign(m_chunkCols * m_chunkRows, ChunkCache());
+        cache.resident.clear();
+    }
+}
+
+void LevelDesigner::MarkDirty(TileLayer layer, int col, int row, int cols, int rows)
+{
+    // Caches of another level are rebuilt whole on the next Render()
+    LayerCache& cache = m_layerCache[static_cast<int>(layer)];
+    if (cache.chunks.empty() || m_cachedLevel.get() != m_level)
+        return;
+
+    SDL_Rect area{ col, row, cols, rows };
+
+    int chunkCol0 = col / CHUNK_CELLS;
+    int chunkRow0 = row / CHUNK_CELLS;
+    int chunkCol1 = std::min(m_chunkCols - 1, (col + cols - 1) / CHUNK_CELLS);
+    int chunkRow1 = std::min(m_chunkRows - 1, (row + rows - 1) / CHUNK_CELLS);
+
+    for (int chunkRow = chunkRow0; chunkRow <= chunkRow1; ++chunkRow)
+    {
+        for (int chunkCol = chunkCol0; chunkCol <= chunkCol1; ++chunkCol)
         {
-            const Cell& cell = m_grid[row][col];
-            if (!cell.filled || !m_tileset)
+            ChunkCache& chunk = cache.chunks[chunkRow * m_chunkCols + chunkCol];
+            chunk.empty = false;
+
+            // Chunks without a texture are redrawn whole anyway
+            if (!chunk.target)
                 continue;
 
-            int dstX = col * TILE_SIZE_SCREEN;
-            int dstY = row * TILE_SIZE_SCREEN;
-
-           
-            texMgr.DrawTileScaled(
-                m_tileset,
-                renderer,
-                TILE_SIZE_SHEET,      
-                TILE_SIZE_SCREEN,     
-                cell.tileX,
-                cell.tileY,
-                dstX,
-                dstY
-            );
+            SDL_Rect chunkCells{ chunkCol * CHUNK_CELLS, chunkRow * CHUNK_CELLS, CHUNK_CELLS, CHUNK_CELLS };
+            SDL_Rect part;
+            if (!SDL_IntersectRect(&area, &chunkCells, &part))
+                continue;
+
+            if (chunk.dirty.w <= 0)
+                chunk.dirty = part;
+            else
+                SDL_UnionRect(&chunk.dirty, &part, &chunk.dirty);
         }
     }
+}
+
+void LevelDesigner::MarkAllDirty()
+{
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+        MarkDirty(static_cast<TileLayer>(layer), 0, 0, m_level->cols, m_level->rows);
+}
+
+void LevelDesigner::BuildGridLines(const SDL_Rect& view)
+{
+    // One connected path that zig-zags down every visible vertical line
+    // and then across every visible horizontal line. The connecting
+    // segments run along the edge of the visible area.
+    SDL_Rect cells = VisibleCells(*m_cachedLevel, view);
+
+    m_gridLinePoints.clear();
+    if (cells.w <= 0 || cells.h <= 0)
+        return;
 
-    // Draw grid lines on top
-    SDL_SetRenderDrawColor(renderer, 80, 80, 80, 255);
+    const int left = cells.x * TILE_SIZE_SCREEN - view.x;
+    const int top = cells.y * TILE_SIZE_SCREEN - view.y;
+    const int right = left + cells.w * TILE_SIZE_SCREEN;
+    const int bottom = top + cells.h * TILE_SIZE_SCREEN;
 
-    // vertical lines
-    for (int x = 0; x <= GRID_COLS * TILE_SIZE_SCREEN; x += TILE_SIZE_SCREEN)
+    for (int i = 0; i <= cells.w; ++i)
     {
-        SDL_RenderDrawLine(renderer, x, 0, x, GRID_ROWS * TILE_SIZE_SCREEN);
+        int x = left + i * TILE_SIZE_SCREEN;
+        bool down = (i % 2) == 0;
+        m_gridLinePoints.push_back(SDL_Point{ x, down ? top : bottom });
+        m_gridLinePoints.push_back(SDL_Point{ x, down ? bottom : top });
     }
 
-    // horizontal lines
-    for (int y = 0; y <= GRID_ROWS * TILE_SIZE_SCREEN; y += TILE_SIZE_SCREEN)
+    // Continue from whichever corner the verticals ended on
+    bool endedAtBottom = (cells.w % 2) == 0;
+    for (int i = 0; i <= cells.h; ++i)
     {
-        SDL_RenderDrawLine(renderer, 0, y, GRID_COLS * TILE_SIZE_SCREEN, y);
+        int y = endedAtBottom ? bottom - i * TILE_SIZE_SCREEN : top + i * TILE_SIZE_SCREEN;
+        bool leftward = (i % 2) == 0;
+        m_gridLinePoints.push_back(SDL_Point{ leftward ? right : left, y });
+        m_gridLinePoints.push_back(SDL_Point{ leftward ? left : right, y });
     }
 }
 
 bool LevelDesigner::SaveToFile(const std::string& path) const
+{
+    std::vector<Uint8> bytes;
+    Serialize(bytes);
+    return LevelSaver::WriteFileAtomic(path, bytes);
+}
+
+void LevelDesigner::Serialize(std::vector<Uint8>& bytes) const
+{
+    const size_t cellCount = static_cast<size_t>(m_level->cols) * m_level->rows;
+    bytes.assign(LEVEL_HEADER_SIZE + LAYER_COUNT * cellCount * LEVEL_CELL_SIZE, 0);
+
+    std::memcpy(bytes.data(), LEVEL_MAGIC, sizeof(LEVEL_MAGIC));
+    WriteU32(bytes.data() + 4, LEVEL_VERSION);
+    WriteU32(bytes.data() + 8, static_cast<Uint32>(m_level->cols));
+    WriteU32(bytes.data() + 12, static_cast<Uint32>(m_level->rows));
+    WriteU32(bytes.data() + 16, static_cast<Uint32>(LAYER_COUNT));
+
+    Uint8* record = bytes.data() + LEVEL_HEADER_SIZE;
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        for (int row = 0; row < m_level->rows; ++row)
+        {
+            for (int col = 0; col < m_level->cols; ++col)
+            {
+                WriteU16(record, GetTile(static_cast<TileLayer>(layer), col, row));
+                record += LEVEL_CELL_SIZE;
+            }
+        }
+    }
+}
+
+bool LevelDesigner::ExportText(const std::string& path) const
 {
     std::ofstream out(path);
     if (!out)
@@ -176,20 +636,24 @@ bool LevelDesigner::SaveToFile(const std::string& path) const
         return false;
     }
 
-    // First write dimensions in case you change them later
-    out << GRID_ROWS << ' ' << GRID_COLS << '\n';
+    // First write dimensions (levels can be any size)
+    out << m_level->rows << ' ' << m_level->cols << ' ' << LAYER_COUNT << '\n';
 
-    // Then write each cell: filled, tileX, tileY
-    for (int row = 0; row < GRID_ROWS; ++row)
+    // Then each layer (background, terrain, foreground), each cell: filled, tileX, tileY
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
     {
-        for (int col = 0; col < GRID_COLS; ++col)
+        for (int row = 0; row < m_level->rows; ++row)
         {
-            const Cell& cell = m_grid[row][col];
-            int filledInt = cell.filled ? 1 : 0;
-
-            out << filledInt << ' ' << cell.tileX << ' ' << cell.tileY << ' ';
+            for (int col = 0; col < m_level->cols; ++col)
+            {
+                TileId id = GetTile(static_cast<TileLayer>(layer), col, row);
+                if (id == EMPTY_TILE)
+                    out << "0 0 0 ";
+                else
+                    out << "1 " << TileIdX(id) << ' ' << TileIdY(id) << ' ';
+            }
+            out << '\n';
         }
-        out << '\n';
     }
 
     return true;
@@ -197,141 +661,781 @@ bool LevelDesigner::SaveToFile(const std::string& path) const
 
 bool LevelDesigner::LoadFromFile(const std::string& path)
 {
-    std::ifstream in(path);
-    if (!in)
+    // A saved (edited) level on disk wins over the packed copy
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (in)
+    {
+        std::streamoff size = in.tellg();
+        in.seekg(0);
+
+        m_fileBuffer.resize(static_cast<size_t>(std::max<std::streamoff>(size, 0)));
+        if (!in.read(reinterpret_cast<char*>(m_fileBuffer.data()), static_cast<std::streamsize>(m_fileBuffer.size())))
+        {
+            SDL_Log("LevelDesigner: failed to read %s", path.c_str());
+            return false;
+        }
+
+        return LoadFromMemory(m_fileBuffer.data(), m_fileBuffer.size(), path);
+    }
+
+    // The archive is already mapped: parse straight out of it
+    const AssetArchive::Entry* packed = AssetArchive::Instance().Find(path);
+    if (packed && packed->kind == AssetArchive::EntryKind::File)
+        return LoadFromMemory(packed->data, packed->size, path);
+
+    // No file yet = first run. Not an error.
+    SDL_Log("LevelDesigner: no existing level file %s, starting empty", path.c_str());
+    return false;
+}
+
+bool LevelDesigner::LoadFromMemory(const Uint8* data, size_t size, const std::string& path)
+{
+    if (size >= sizeof(LEVEL_MAGIC) && std::memcmp(data, LEVEL_MAGIC, sizeof(LEVEL_MAGIC)) == 0)
+        return LoadBinary(data, size, path);
+
+    // Text .map (older saves, ExportText() output)
+    std::istringstream in(std::string(reinterpret_cast<const char*>(data), size));
+    return LoadFromStream(in, path);
+}
+
+bool LevelDesigner::LoadBinary(const Uint8* data, size_t size, const std::string& path)
+{
+    if (size < LEVEL_HEADER_SIZE)
     {
-        // No file yet = first run. Not an error.
-        SDL_Log("LevelDesigner: no existing level file %s, starting empty", path.c_str());
+        SDL_Log("LevelDesigner: truncated header in %s", path.c_str());
         return false;
     }
 
-    int fileRows = 0, fileCols = 0;
-    in >> fileRows >> fileCols;
+    Uint32 version = ReadU32(data + 4);
+    if (version < 1 || version > LEVEL_VERSION)
+    {
+        SDL_Log("LevelDesigner: %s has unsupported version %u", path.c_str(), static_cast<unsigned>(version));
+        return false;
+    }
 
-    if (!in)
+    Uint32 fileCols = ReadU32(data + 8);
+    Uint32 fileRows = ReadU32(data + 12);
+    Uint32 fileLayers = ReadU32(data + 16);
+
+    const Uint32 maxSize = MAX_GRID_SIZE;
+    if (fileRows == 0 || fileCols == 0 || fileRows > maxSize || fileCols > maxSize || fileLayers > LEVEL_MAX_LAYERS)
     {
-        SDL_Log("LevelDesigner: failed to read header from %s", path.c_str());
+        SDL_Log("LevelDesigner: bad level size in %s (%ux%u)", path.c_str(),
+            static_cast<unsigned>(fileRows), static_cast<unsigned>(fileCols));
         return false;
     }
 
-    if (fileRows != GRID_ROWS || fileCols != GRID_COLS)
+    const size_t cellCount = static_cast<size_t>(fileCols) * fileRows;
+    const size_t cellSize = (version == 1) ? LEVEL_CELL_SIZE_V1 : LEVEL_CELL_SIZE;
+    if (size < LEVEL_HEADER_SIZE + fileLayers * cellCount * cellSize)
     {
-        SDL_Log("LevelDesigner: size mismatch in %s (file %dx%d, grid %dx%d).",
-            path.c_str(), fileRows, fileCols, GRID_ROWS, GRID_COLS);
-        // We can still attempt to read min(file, grid) safely.
+        SDL_Log("LevelDesigner: truncated cell data in %s", path.c_str());
+        return false;
     }
 
-    for (int row = 0; row < GRID_ROWS; ++row)
+    m_level->cols = static_cast<int>(fileCols);
+    m_level->rows = static_cast<int>(fileRows);
+    ResetTiles();
+
+    // Layers missing from the file stay empty, extra ones are skipped
+    const int layers = std::min(static_cast<int>(fileLayers), static_cast<int>(LAYER_COUNT));
+    const Uint8* record = data + LEVEL_HEADER_SIZE;
+    for (int layer = 0; layer < layers; ++layer)
     {
-        for (int col = 0; col < GRID_COLS; ++col)
+        for (int row = 0; row < m_level->rows; ++row)
         {
-            int filledInt = 0;
-            int tileX = 0;
-            int tileY = 0;
-
-            if (!(in >> filledInt >> tileX >> tileY))
+            for (int col = 0; col < m_level->cols; ++col, record += cellSize)
             {
-                // If file ends early, fill the rest with empty cells.
-                m_grid[row][col].filled = false;
-                m_grid[row][col].tileX = 0;
-                m_grid[row][col].tileY = 0;
+                TileId id = (version == 1)
+                    ? (record[0] ? MakeTileId(record[1], record[2]) : EMPTY_TILE)
+                    : ReadU16(record);
+
+                if (id != EMPTY_TILE)
+                    PutTile(static_cast<TileLayer>(layer), col, row, id);
             }
-            else
+        }
+    }
+
+    m_level->dirty = false;
+    ResetCaches();
+    return true;
+}
+
+bool LevelDesigner::LoadFromStream(std::istream& in, const std::string& path)
+{
+    // "rows cols layers"; older files have no layer count and
+    // hold only the terrain layer
+    std::string headerLine;
+    std::getline(in, headerLine);
+    std::istringstream header(headerLine);
+
+    int fileRows = 0, fileCols = 0, fileLayers = 0;
+    header >> fileRows >> fileCols;
+
+    if (!header)
+    {
+        SDL_Log("LevelDesigner: failed to read header from %s", path.c_str());
+        return false;
+    }
+
+    if (fileRows <= 0 || fileCols <= 0 || fileRows > MAX_GRID_SIZE || fileCols > MAX_GRID_SIZE)
+    {
+        SDL_Log("LevelDesigner: bad level size in %s (%dx%d)", path.c_str(), fileRows, fileCols);
+        return false;
+    }
+
+    if (!(header >> fileLayers))
+        fileLayers = 0; // legacy single-layer file
+
+    // The grid takes the size stored in the file
+    m_level->cols = fileCols;
+    m_level->rows = fileRows;
+    ResetTiles();
+
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        // Legacy files only fill the terrain layer
+        bool inFile = (fileLayers == 0) ? (layer == static_cast<int>(TileLayer::Terrain)) : (layer < fileLayers);
+        if (!inFile)
+            continue;
+
+        bool ended = false;
+        for (int row = 0; row < m_level->rows && !ended; ++row)
+        {
+            for (int col = 0; col < m_level->cols; ++col)
             {
-                m_grid[row][col].filled = (filledInt != 0);
-                m_grid[row][col].tileX = tileX;
-                m_grid[row][col].tileY = tileY;
+                int filledInt = 0;
+                int tileX = 0;
+                int tileY = 0;
+
+                // If file ends early, the rest stays empty.
+                if (!(in >> filledInt >> tileX >> tileY))
+                {
+                    ended = true;
+                    break;
+                }
+
+                if (filledInt != 0 && tileX >= 0 && tileX <= 0xFF && tileY >= 0 && tileY <= 0xFF)
+                    PutTile(static_cast<TileLayer>(layer), col, row, MakeTileId(tileX, tileY));
             }
         }
     }
 
+    m_level->dirty = false;
+    ResetCaches();
     return true;
 }
 
-bool LevelDesigner::SaveCurrentLevel() const
+bool LevelDesigner::SaveLevel(int index)
 {
-    if (m_activeLevelIndex < 0 || m_activeLevelIndex >= MAX_LEVELS)
+    if (index < 0 || index >= GetLevelCount())
         return false;
 
-    return SaveToFile(m_levelPaths[m_activeLevelIndex]);
+    // Not cached = nothing that could have changed
+    if (!m_levels[index])
+        return true;
+
+    Level& level = *m_levels[index];
+    const std::string& path = m_registry.GetLevelPath(index);
+
+    // Compact a journal that has grown long into a full save
+    if (level.journalRecordsOnDisk + level.journal.GetPendingCount() > JOURNAL_COMPACT_RECORDS)
+        level.dirty = true;
+
+    std::vector<Uint8> bytes;
+
+    if (!level.dirty)
+    {
+        if (level.journal.GetPendingCount() == 0)
+            return true;
+
+        // Only the edit records since the last save: O(edits), not O(map).
+        // The first batch starts a new sidecar file, later ones append.
+        size_t count = level.journal.GetPendingCount();
+        bool newFile = level.journalRecordsOnDisk == 0;
+        level.journal.TakePending(bytes, newFile);
+
+        if (newFile)
+            m_saver.Queue(JournalPath(path), std::move(bytes));
+        else
+            m_saver.QueueAppend(JournalPath(path), std::move(bytes));
+
+        level.journalRecordsOnDisk += count;
+        return true;
+    }
+
+    // Snapshot the grid here (Serialize() reads the active level), the
+    // file write happens on the I/O thread
+    Level* active = m_level;
+    m_level = &level;
+    Serialize(bytes);
+    m_level = active;
+
+    // The full save holds every journaled edit: the sidecar goes (after
+    // the level is written, the jobs run in order)
+    m_saver.Queue(path, std::move(bytes));
+    m_saver.QueueRemove(JournalPath(path));
+
+    level.journal.TakePending(bytes, false);
+    level.journalRecordsOnDisk = 0;
+    level.dirty = false;
+    return true;
 }
 
-bool LevelDesigner::LoadCurrentLevel()
+void LevelDesigner::FlushSaves()
+{
+    m_saver.Flush();
+}
+
+bool LevelDesigner::LoadLevel(int index)
 {
-    if (m_activeLevelIndex < 0 || m_activeLevelIndex >= MAX_LEVELS)
+    if (index < 0 || index >= GetLevelCount())
         return false;
 
-    return LoadFromFile(m_levelPaths[m_activeLevelIndex]);
+    // Writes of this level still queued have to land before reading it
+    m_saver.Flush();
+
+    // A prefetched copy would be older than what is read here
+    {
+        std::unique_lock<std::mutex> lock(m_prefetchMutex);
+        if (m_prefetchRequested == index)
+            m_prefetchRequested = -1;
+
+        m_prefetchDone.wait(lock, [this, index]() { return m_prefetchLoading != index; });
+
+        if (m_prefetchReadyIndex == index)
+        {
+            m_prefetchReady.reset();
+            m_prefetchReadyIndex = -1;
+        }
+    }
+
+    const std::string& path = m_registry.GetLevelPath(index);
+    Level& level = m_levels[index] ? *m_levels[index] : CreateLevel(index);
+
+    Level* active = m_level;
+    m_level = &level;
+    bool ok = LoadFromFile(path);
+    ReplayJournal(path);
+    m_level = active;
+
+    if (!ok)
+    {
+        SDL_Log("LevelDesigner: starting new empty level at %s",
+            path.c_str());
+    }
+
+    TouchLevel(level);
+    EvictLevels();
+    return ok;
+}
+
+LevelDesigner::Level& LevelDesigner::CreateLevel(int index)
+{
+    m_levels[index].reset(new Level);
+
+    Level* active = m_level;
+    m_level = m_levels[index].get();
+    ResetTiles();
+    m_level = active;
+
+    return *m_levels[index];
+}
+
+size_t LevelDesigner::LevelBytes(const Level& level)
+{
+    size_t bytes = sizeof(Level) + level.solidMask.size() * sizeof(Uint64) +
+        level.journal.GetHistorySize() * sizeof(EditRecord);
+
+    for (const std::vector<std::unique_ptr<TileChunk>>& chunks : level.tiles)
+    {
+        bytes += chunks.size() * sizeof(std::unique_ptr<TileChunk>);
+        for (const std::unique_ptr<TileChunk>& chunk : chunks)
+        {
+            if (chunk)
+                bytes += sizeof(TileChunk);
+        }
+    }
+    return bytes;
+}
+
+size_t LevelDesigner::GetCacheBytes() const
+{
+    size_t bytes = 0;
+    for (const std::shared_ptr<Level>& level : m_levels)
+    {
+        if (level)
+            bytes += LevelBytes(*level);
+    }
+    return bytes;
+}
+
+bool LevelDesigner::IsLevelCached(int index) const
+{
+    return index >= 0 && index < GetLevelCount() && m_levels[index] != nullptr;
+}
+
+void LevelDesigner::GetCachedLevels(std::vector<int>& outLevels) const
+{
+    outLevels.clear();
+    for (int i = 0; i < static_cast<int>(m_levels.size()); ++i)
+    {
+        if (m_levels[i])
+            outLevels.push_back(i);
+    }
 }
 
-void LevelDesigner::SetActiveLevel(int index)
+void LevelDesigner::PrefetchLevel(int index)
 {
-    if (index < 0 || index >= MAX_LEVELS)
+    if (index < 0 || index >= GetLevelCount())
         return;
 
-    // Save the current level before switching
-    SaveCurrentLevel();
+    AdoptPrefetched();
+    if (m_levels[index])
+        return;
 
-    m_activeLevelIndex = index;
+    {
+        std::lock_guard<std::mutex> lock(m_prefetchMutex);
+        if (m_prefetchRequested == index || m_prefetchLoading == index || m_prefetchReadyIndex == index)
+            return;
+
+        // Replaces a request the worker hasn't picked up yet
+        m_prefetchRequested = index;
+        m_prefetchPath = m_registry.GetLevelPath(index);
+        m_prefetchTileProperties = m_tileProperties;
+
+        if (!m_prefetchThread.joinable())
+            m_prefetchThread = std::thread(&LevelDesigner::PrefetchMain, this);
+    }
+    m_prefetchWake.notify_one();
+}
 
-    // Load the new level (or start empty if file missing)
-    if (!LoadCurrentLevel())
+void LevelDesigner::PrefetchMain()
+{
+    std::unique_lock<std::mutex> lock(m_prefetchMutex);
+
+    while (true)
     {
-        SDL_Log("LevelDesigner: starting new empty level at %s",
-            m_levelPaths[m_activeLevelIndex].c_str());
+        m_prefetchWake.wait(lock, [this]() { return m_prefetchQuit || m_prefetchRequested >= 0; });
+        if (m_prefetchQuit)
+            return;
+
+        const int index = m_prefetchRequested;
+        const std::string path = m_prefetchPath;
+        m_prefetchLoading = index;
+        m_prefetchRequested = -1;
+
+        LevelDesigner decoder;
+        decoder.autoSaveEnabled = false;
+        decoder.m_tileProperties = m_prefetchTileProperties;
+
+        lock.unlock();
+
+        // An evicted level may still have its save queued
+        m_saver.Flush();
+
+        if (!decoder.LoadFromFile(path))
+            SDL_Log("LevelDesigner: starting new empty level at %s", path.c_str());
+        decoder.ReplayJournal(path);
+
+        std::shared_ptr<Level> level = std::move(decoder.m_levels[decoder.m_activeLevelIndex]);
+        decoder.m_level = nullptr;
+
+        lock.lock();
+
+        // An older result nobody picked up is dropped (it was only a guess)
+        m_prefetchReady = std::move(level);
+        m_prefetchReadyIndex = index;
+        m_prefetchLoading = -1;
+        m_prefetchDone.notify_all();
+    }
+}
+
+void LevelDesigner::AdoptPrefetched(int waitForIndex)
+{
+    std::shared_ptr<Level> level;
+    int index = -1;
+
+    {
+        std::unique_lock<std::mutex> lock(m_prefetchMutex);
+
+        if (waitForIndex >= 0)
+        {
+            m_prefetchDone.wait(lock, [this, waitForIndex]()
+                {
+                    return m_prefetchRequested != waitForIndex && m_prefetchLoading != waitForIndex;
+                });
+        }
+
+        if (!m_prefetchReady)
+            return;
+
+        level = std::move(m_prefetchReady);
+        index = m_prefetchReadyIndex;
+        m_prefetchReadyIndex = -1;
+    }
+
+    // Loaded the normal way in the meantime: keep that one
+    if (m_levels[index])
+        return;
+
+    m_levels[index] = std::move(level);
+    TouchLevel(*m_levels[index]);
+    EvictLevels();
+
+    SDL_Log("LevelDesigner: level %d prefetched", index + 1);
+}
+
+void LevelDesigner::SetCacheBudget(size_t bytes)
+{
+    m_cacheBudget = bytes;
+    EvictLevels();
+}
+
+void LevelDesigner::EvictLevels()
+{
+    size_t bytes = GetCacheBytes();
+
+    while (bytes > m_cacheBudget)
+    {
+        // Least recently used first. The active level and the one just
+        // touched (being switched to) always stay.
+        int victim = -1;
+        for (int i = 0; i < static_cast<int>(m_levels.size()); ++i)
+        {
+            const Level* level = m_levels[i].get();
+            if (!level || level == m_level || level->lastUsed == m_useCounter)
+                continue;
+
+            // Edits can only be dropped once they can be written out
+            bool unsaved = level->dirty || level->journal.GetPendingCount() > 0;
+            if (unsaved && !autoSaveEnabled)
+                continue;
+
+            if (victim < 0 || level->lastUsed < m_levels[victim]->lastUsed)
+                victim = i;
+        }
+
+        if (victim < 0)
+            break;
+
+        // Snapshot any edits first (the write itself is queued)
+        SaveLevel(victim);
+
+        // Snapshots (and the render caches) may still hold it
+        bytes -= LevelBytes(*m_levels[victim]);
+        m_levels[victim].reset();
+        SDL_Log("LevelDesigner: evicted level %d from the cache", victim + 1);
+    }
+}
+
+void LevelDesigner::ReplayJournal(const std::string& levelPath)
+{
+    m_level->journal.Clear();
+    m_level->journalRecordsOnDisk = 0;
+
+    const std::string path = JournalPath(levelPath);
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return; // no edits since the last full save
+
+    std::streamoff size = in.tellg();
+    in.seekg(0);
+
+    m_fileBuffer.resize(static_cast<size_t>(std::max<std::streamoff>(size, 0)));
+    std::vector<EditRecord> records;
+    if (!in.read(reinterpret_cast<char*>(m_fileBuffer.data()), static_cast<std::streamsize>(m_fileBuffer.size())) ||
+        !EditJournal::ReadFile(m_fileBuffer.data(), m_fileBuffer.size(), records))
+    {
+        SDL_Log("LevelDesigner: ignoring unreadable journal %s", path.c_str());
+        return;
+    }
+
+    // Records hold absolute tiles, so replaying in order rebuilds the
+    // grid as it was after the last journaled edit
+    int applied = 0;
+    for (const EditRecord& record : records)
+    {
+        if (record.layer >= LAYER_COUNT || record.col >= m_level->cols || record.row >= m_level->rows)
+            continue;
+
+        PutTile(static_cast<TileLayer>(record.layer), record.col, record.row, record.newTile);
+        ++applied;
+    }
+
+    // Fold the recovered edits into the level file on the next save
+    // (that also drops a torn record at the end of the journal)
+    m_level->dirty = true;
+    SDL_Log("LevelDesigner: replayed %d edits from %s", applied, path.c_str());
+}
+
+bool LevelDesigner::Undo()
+{
+    if (!m_level->journal.Undo(m_editScratch))
+        return false;
+
+    ApplyEdits(m_editScratch, true);
+    return true;
+}
+
+bool LevelDesigner::Redo()
+{
+    if (!m_level->journal.Redo(m_editScratch))
+        return false;
+
+    ApplyEdits(m_editScratch, false);
+    return true;
+}
+
+void LevelDesigner::ApplyEdits(const std::vector<EditRecord>& records, bool useOld)
+{
+    for (const EditRecord& record : records)
+    {
+        if (record.layer >= LAYER_COUNT || record.col >= m_level->cols || record.row >= m_level->rows)
+            continue;
+
+        TileLayer layer = static_cast<TileLayer>(record.layer);
+        PutTile(layer, record.col, record.row, useOld ? record.oldTile : record.newTile);
+        MarkDirty(layer, record.col, record.row, 1, 1);
     }
+}
+
+bool LevelDesigner::SaveCurrentLevel()
+{
+    return SaveLevel(m_activeLevelIndex);
+}
+
+bool LevelDesigner::SaveModifiedLevels()
+{
+    bool ok = true;
+    for (int i = 0; i < GetLevelCount(); ++i)
+        ok = SaveLevel(i) && ok;
+    return ok;
+}
+
+bool LevelDesigner::LoadCurrentLevel()
+{
+    return LoadLevel(m_activeLevelIndex);
+}
+
+bool LevelDesigner::SetActiveLevel(int index)
+{
+    if (index < 0 || index >= GetLevelCount())
+        return false;
+
+    // Called on the sim thread (door travel): only take what is already
+    // decoded, the disk belongs to the prefetch worker
+    AdoptPrefetched();
+    if (!m_levels[index])
+        return false;
+
+    m_activeLevelIndex = index;
+    m_level = m_levels[index].get();
+    TouchLevel(*m_level);
+    EvictLevels();
 
     SDL_Log("LevelDesigner: switched to level %d (%s)",
         m_activeLevelIndex + 1,
-        m_levelPaths[m_activeLevelIndex].c_str());
+        m_registry.GetLevelPath(m_activeLevelIndex).c_str());
+    return true;
 }
 
 
-bool LevelDesigner::IsSolidCell(int col, int row) const
+bool LevelDesigner::IsAnySolidInRow(int colLeft, int colRight, int row) const
 {
+    if (colLeft > colRight)
+        return false;
+
     // Outside map = solid
-    if (row < 0 || row >= GRID_ROWS || col < 0 || col >= GRID_COLS)
+    if (row < 0 || row >= m_level->rows || colLeft < 0 || colRight >= m_level->cols)
         return true;
 
-    const Cell& cell = m_grid[row][col];
-
-    // If nothing painted here = solid 
-    if (!cell.filled)
-        return true;
+    // One masked test per 64 cells
+    const Uint64* words = &m_level->solidMask[row * m_level->solidWordsPerRow];
+    const int firstWord = colLeft >> 6;
+    const int lastWord = colRight >> 6;
 
-    if (cell.tileY >= 6 && cell.tileY <= 8 &&    // tiles filled on ground
-		cell.tileX >= 0 && cell.tileX <= 8)      // tiles filled on ground
+    for (int w = firstWord; w <= lastWord; ++w)
     {
-        return false; // walkable
+        Uint64 mask = ~Uint64(0);
+        if (w == firstWord)
+            mask &= ~Uint64(0) << (colLeft & 63);
+        if (w == lastWord)
+            mask &= ~Uint64(0) >> (63 - (colRight & 63));
+
+        if (words[w] & mask)
+            return true;
     }
 
-    // everything else is solid
-    return true;
+    return false;
 }
 
-void LevelDesigner::ApplyBrush(int mouseX, int mouseY, bool erase)
+Uint8 LevelDesigner::GetTileFlags(int col, int row) const
 {
-    int col = mouseX / TILE_SIZE_SCREEN;
-    int row = mouseY / TILE_SIZE_SCREEN;
+    if (row < 0 || row >= m_level->rows || col < 0 || col >= m_level->cols)
+        return TileProperties::SOLID;
 
-    if (row < 0 || row >= GRID_ROWS || col < 0 || col >= GRID_COLS)
-        return;
+    // If nothing painted here = solid
+    TileId id = GetTile(TileLayer::Terrain, col, row);
+    if (id == EMPTY_TILE)
+        return TileProperties::SOLID;
+
+    return m_tileProperties.GetFlags(TileIdX(id), TileIdY(id));
+}
+
+void LevelDesigner::RebuildSolidMask()
+{
+    m_level->solidWordsPerRow = (m_level->cols + 63) >> 6;
+    m_level->solidMask.assign(m_level->solidWordsPerRow * m_level->rows, ~Uint64(0));
+
+    for (int row = 0; row < m_level->rows; ++row)
+    {
+        for (int col = 0; col < m_level->cols; ++col)
+        {
+            if (!IsSolidTile(GetTile(TileLayer::Terrain, col, row)))
+                SetSolidBit(col, row, false);
+        }
+    }
+}
+
+void LevelDesigner::Resize(int cols, int rows)
+{
+    const int maxSize = MAX_GRID_SIZE;
+    cols = std::max(1, std::min(cols, maxSize));
+    rows = std::max(1, std::min(rows, maxSize));
+
+    const int chunkCols = (cols + TILE_CHUNK_MASK) >> TILE_CHUNK_SHIFT;
+    const int chunkRows = (rows + TILE_CHUNK_MASK) >> TILE_CHUNK_SHIFT;
+    const int keepCols = std::min(chunkCols, m_level->tileChunkCols);
+    const int keepRows = std::min(chunkRows, m_level->tileChunkRows);
+
+    // Overlapping chunks move over as they are; only cells cut off by a
+    // shrink are cleared, so growing again later brings back empty cells
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        std::vector<std::unique_ptr<TileChunk>> resized(chunkCols * chunkRows);
+
+        for (int chunkRow = 0; chunkRow < keepRows; ++chunkRow)
+        {
+            for (int chunkCol = 0; chunkCol < keepCols; ++chunkCol)
+            {
+                std::unique_ptr<TileChunk>& chunk = m_level->tiles[layer][chunkRow * m_level->tileChunkCols + chunkCol];
+                if (!chunk)
+                    continue;
+
+                for (int y = 0; y < TILE_CHUNK_CELLS; ++y)
+                {
+                    for (int x = 0; x < TILE_CHUNK_CELLS; ++x)
+                    {
+                        if ((chunkCol << TILE_CHUNK_SHIFT) + x >= cols || (chunkRow << TILE_CHUNK_SHIFT) + y >= rows)
+                            chunk->tiles[y * TILE_CHUNK_CELLS + x] = EMPTY_TILE;
+                    }
+                }
+
+                resized[chunkRow * chunkCols + chunkCol] = std::move(chunk);
+            }
+        }
+
+        m_level->tiles[layer].swap(resized);
+    }
+
+    m_level->cols = cols;
+    m_level->rows = rows;
+    m_level->tileChunkCols = chunkCols;
+    m_level->tileChunkRows = chunkRows;
+    m_level->dirty = true;
+    m_level->journal.Clear();   // records may point outside the new size
+    RebuildSolidMask();
+    ResetCaches();
+}
 
-    Cell& cell = m_grid[row][col];
+void LevelDesigner::ResetTiles()
+{
+    m_level->tileChunkCols = (m_level->cols + TILE_CHUNK_MASK) >> TILE_CHUNK_SHIFT;
+    m_level->tileChunkRows = (m_level->rows + TILE_CHUNK_MASK) >> TILE_CHUNK_SHIFT;
 
-    if (erase)
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
     {
-        cell.filled = false;
+        m_level->tiles[layer].clear();
+        m_level->tiles[layer].resize(m_level->tileChunkCols * m_level->tileChunkRows);
     }
-    else
+
+    // Nothing painted = all solid
+    m_level->solidWordsPerRow = (m_level->cols + 63) >> 6;
+    m_level->solidMask.assign(m_level->solidWordsPerRow * m_level->rows, ~Uint64(0));
+}
+
+void LevelDesigner::PutTile(TileLayer layer, int col, int row, TileId id)
+{
+    std::unique_ptr<TileChunk>& chunk =
+        m_level->tiles[static_cast<int>(layer)][(row >> TILE_CHUNK_SHIFT) * m_level->tileChunkCols + (col >> TILE_CHUNK_SHIFT)];
+
+    if (!chunk)
     {
-        cell.filled = true;
-        cell.tileX = m_selectedTileX;
-        cell.tileY = m_selectedTileY;
+        if (id == EMPTY_TILE)
+            return; // already empty
+
+        chunk.reset(new TileChunk);
+        std::fill(std::begin(chunk->tiles), std::end(chunk->tiles), EMPTY_TILE);
     }
+
+    chunk->tiles[(row & TILE_CHUNK_MASK) * TILE_CHUNK_CELLS + (col & TILE_CHUNK_MASK)] = id;
+
+    if (layer == TileLayer::Terrain)
+        SetSolidBit(col, row, IsSolidTile(id));
 }
 
+void LevelDesigner::SetCell(int col, int row, bool filled, int tileX, int tileY, TileLayer layer)
+{
+    if (row < 0 || row >= m_level->rows || col < 0 || col >= m_level->cols)
+        return;
 
+    // Tile ids hold 8-bit sheet coordinates
+    if (filled && (tileX < 0 || tileX > 0xFF || tileY < 0 || tileY > 0xFF))
+        return;
 
+    TileId id = filled ? MakeTileId(tileX, tileY) : EMPTY_TILE;
+    if (GetTile(layer, col, row) == id)
+        return;
 
+    PutTile(layer, col, row, id);
+    m_level->dirty = true;
+    m_level->journal.Clear();   // undo would restore tiles from before this
+    MarkDirty(layer, col, row, 1, 1);
+}
 
+void LevelDesigner::ClearGrid()
+{
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+        for (std::unique_ptr<TileChunk>& chunk : m_level->tiles[layer])
+            chunk.reset();
+
+    std::fill(m_level->solidMask.begin(), m_level->solidMask.end(), ~Uint64(0));
+    m_level->dirty = true;
+    m_level->journal.Clear();
+
+    MarkAllDirty();
+}
+
+void LevelDesigner::ApplyBrush(int worldX, int worldY, bool erase)
+{
+    if (worldX < 0 || worldY < 0)
+        return;
+
+    int col = worldX / TILE_SIZE_SCREEN;
+    int row = worldY / TILE_SIZE_SCREEN;
+
+    if (row < 0 || row >= m_level->rows || col < 0 || col >= m_level->cols)
+        return;
+
+    // Dragging over cells that already hold the brush tile changes nothing
+    TileId id = erase ? EMPTY_TILE : MakeTileId(m_selectedTileX, m_selectedTileY);
+    if (GetTile(m_activeLayer, col, row) == id)
+        return;
+
+    // Journaled, not a full save (see SaveLevel())
+    m_level->journal.Record(col, row, static_cast<int>(m_activeLayer), GetTile(m_activeLayer, col, row), id);
+    PutTile(m_activeLayer, col, row, id);
+
+    MarkDirty(m_activeLayer, col, row, 1, 1);
+}
@@ -1,8 +1,30 @@
 #pragma once
 
 #include <SDL.h>
-#include <string>        
+#include <condition_variable>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include "TextureManager.h"
+#include "TileProperties.h"
+#include "LevelSaver.h"
+#include "EditJournal.h"
+#include "LevelRegistry.h"
+
+class Camera;
+
+// Tile layers, drawn in this order. Only Terrain is used for collision;
+// Foreground is drawn over the characters.
+enum class TileLayer
+{
+    Background,
+    Terrain,
+    Foreground,
+    Count
+};
 
 class LevelDesigner
 {
@@ -10,56 +32,372 @@ public:
     static const int TILE_SIZE_SCREEN = 64;  // how big each tile is in the editor
     static const int TILE_SIZE_SHEET = 32;  // actual tile size in the spritesheet
 
-    static const int GRID_COLS = 1280 / TILE_SIZE_SCREEN;
-    static const int GRID_ROWS = 720 / TILE_SIZE_SCREEN;
+    // Size of a new/empty level: one screen. Loaded levels use the
+    // size stored in their file.
+    static const int DEFAULT_GRID_COLS = 1280 / TILE_SIZE_SCREEN;
+    static const int DEFAULT_GRID_ROWS = 720 / TILE_SIZE_SCREEN;
+
+    // Sanity limit for level files
+    static const int MAX_GRID_SIZE = 4096;
+
+    static const int LAYER_COUNT = static_cast<int>(TileLayer::Count);
+
+    // One decoded level: tile layers, collision mask, edit journal
+    struct Level;
+
+    // Render snapshots hold the active level of their tick, so the
+    // render thread draws it without the level lock. A level evicted
+    // meanwhile lives on until the last snapshot lets go of it.
+    using LevelRef = std::shared_ptr<const Level>;
 
     LevelDesigner();
     ~LevelDesigner();
 
     bool Init(SDL_Renderer* renderer);
-    void HandleEvent(const SDL_Event& e);
-    void Render(SDL_Renderer* renderer);
 
+    // Mouse positions are converted to world space through the camera
+    void HandleEvent(const SDL_Event& e, const Camera& camera);
+
+    // Render thread: draws 'level' (from a snapshot). Tiles are only
+    // edited on the main thread, which is also the render thread.
+    // Background + Terrain layers (before the characters); only the
+    // part inside the camera view is drawn
+    void Render(SDL_Renderer* renderer, const LevelRef& level, const Camera& camera);
+    // Foreground layer + editor grid (after the characters)
+    void RenderForeground(SDL_Renderer* renderer, const LevelRef& level, const Camera& camera);
+
+    // Levels are stored in a compact binary format (.lvl, see
+    // LevelDesigner.cpp). Loading also accepts the old text .map files;
+    // ExportText() writes that text form for diffs/hand edits.
     bool SaveToFile(const std::string& path) const;
     bool LoadFromFile(const std::string& path);
+    bool ExportText(const std::string& path) const;
+
+    // Levels and doors come from the manifest (LevelRegistry). Decoded
+    // levels are kept in an LRU cache bounded by a memory budget
+    // (cache_mb in the manifest) and switch in by pointer; levels that
+    // aren't cached are decoded by the prefetch worker first. The active
+    // level is never evicted, nor are edits that can't be saved
+    // (autosave off).
+    const LevelRegistry& GetRegistry() const { return m_registry; }
+    int  GetLevelCount() const { return m_registry.GetLevelCount(); }
 
-    void SetActiveLevel(int index);     // 0 or 1
+    // Switch to a cached (or finished prefetched) level, 0 .. count - 1.
+    // Never reads the disk: false = not decoded yet, PrefetchLevel() it
+    // and try again later.
+    bool SetActiveLevel(int index);
     int  GetActiveLevel() const { return m_activeLevelIndex; }
+    LevelRef GetActiveLevelRef() const { return m_levels[m_activeLevelIndex]; }
 
-    bool SaveCurrentLevel() const;
+    // Decode a level on a background thread (map, journal, collision
+    // mask) so entering it later is a pointer swap. Cheap to call every
+    // tick: cached levels and the one already in flight are skipped.
+    // Finished levels join the cache on the next PrefetchLevel(),
+    // SetActiveLevel() or WaitForPrefetch() call.
+    void PrefetchLevel(int index);
+
+    // Block until a requested prefetch of 'index' is decoded and cached
+    // (no-op if it was never requested)
+    void WaitForPrefetch(int index) { AdoptPrefetched(index); }
+
+    bool IsLevelCached(int index) const;
+    void GetCachedLevels(std::vector<int>& outLevels) const;   // ascending ids
+
+    void   SetCacheBudget(size_t bytes);
+    size_t GetCacheBudget() const { return m_cacheBudget; }
+    size_t GetCacheBytes() const;
+
+    // Save the active level / every level if it was edited since it
+    // was loaded or last saved. Unchanged levels never touch the disk.
+    // Brush strokes only append their edit records to a journal file
+    // next to the level (<level>.journal); size changes and direct
+    // SetCell()/ClearGrid() edits write the whole level and drop the
+    // journal. The writes happen on a background I/O thread
+    // (LevelSaver); FlushSaves() waits for them.
+    bool SaveCurrentLevel();
+    bool SaveModifiedLevels();
+    void FlushSaves();
     bool LoadCurrentLevel();
 
+    // Ctrl+Z / Ctrl+Y in the editor: one brush stroke at a time
+    bool Undo();
+    bool Redo();
+
     bool paintingEnabled = true;
-    bool IsSolidCell(int col, int row) const;
+    bool autoSaveEnabled = true;   // save edited levels after each stroke, level switch and on exit
+
+    // Collision reads the terrain solidity bitmask (outside the map and
+    // unpainted cells are solid)
+    bool IsSolidCell(int col, int row) const
+    {
+        if (row < 0 || row >= m_level->rows || col < 0 || col >= m_level->cols)
+            return true;
+        return (m_level->solidMask[row * m_level->solidWordsPerRow + (col >> 6)] >> (col & 63)) & 1;
+    }
+
+    // Any solid cell in [colLeft, colRight] on 'row'? false for an empty span
+    bool IsAnySolidInRow(int colLeft, int colRight, int row) const;
+
+    // Flags of the terrain tile at a cell (TileProperties::SOLID etc.)
+    Uint8 GetTileFlags(int col, int row) const;
+
+    // Level size
+    int GetCols() const { return m_level->cols; }
+    int GetRows() const { return m_level->rows; }
+    int GetWorldWidth()  const { return m_level->cols * TILE_SIZE_SCREEN; }
+    int GetWorldHeight() const { return m_level->rows * TILE_SIZE_SCREEN; }
+
+    // Change the level size, keeping the overlapping cells
+    void Resize(int cols, int rows);
+
+    // Direct cell access for tools/benchmarks (ignores paint mode and
+    // drops the brush undo history)
+    void SetCell(int col, int row, bool filled, int tileX, int tileY,
+        TileLayer layer = TileLayer::Terrain);
+    void ClearGrid();
+
+
+private:
+
+    // Binary or text, decided by the magic number; 'path' is only used
+    // in log messages
+    bool LoadFromMemory(const Uint8* data, size_t size, const std::string& path);
+    bool LoadBinary(const Uint8* data, size_t size, const std::string& path);
+    bool LoadFromStream(std::istream& in, const std::string& path);
+
+    // Active level as a binary level file
+    void Serialize(std::vector<Uint8>& bytes) const;
+
+    // Whole level file, read in one go (reused between loads)
+    std::vector<Uint8> m_fileBuffer;
+
+    // Background writes of edited levels
+    LevelSaver m_saver;
+
+    // Layer caches are split into square chunks so huge levels only
+    // keep textures for what is on (or next to) the screen
+    static const int CHUNK_CELLS = 8;
+    static const int CHUNK_SIZE_SCREEN = CHUNK_CELLS * TILE_SIZE_SCREEN;
+
+    LevelRegistry m_registry;
+    int           m_activeLevelIndex = 0;
+
+    // A cell is a 16-bit tile id: sheet row in the high byte, sheet
+    // column in the low byte (0-based); EMPTY_TILE = nothing painted
+    using TileId = Uint16;
+    static const TileId EMPTY_TILE = 0xFFFF;
+
+    static TileId MakeTileId(int tileX, int tileY) { return static_cast<TileId>((tileY << 8) | tileX); }
+    static int    TileIdX(TileId id) { return id & 0xFF; }
+    static int    TileIdY(TileId id) { return id >> 8; }
+
+    // Cells are stored in square chunks of TILE_CHUNK_CELLS^2, row-major
+    // inside the chunk. Chunks that were never painted aren't allocated,
+    // so mostly-empty layers cost one pointer per chunk.
+    static const int TILE_CHUNK_SHIFT = 5;
+    static const int TILE_CHUNK_CELLS = 1 << TILE_CHUNK_SHIFT;   // 32
+    static const int TILE_CHUNK_MASK = TILE_CHUNK_CELLS - 1;
+
+    struct TileChunk
+    {
+        TileId tiles[TILE_CHUNK_CELLS * TILE_CHUNK_CELLS];
+    };
+
+public:
+    // Cached levels switch in by repointing m_level; files are read when
+    // a level is first needed (or after it was evicted) and written only
+    // when something was edited. Eviction saves pending edits and drops
+    // the undo history. Only LevelDesigner looks inside.
+    struct Level
+    {
+        int cols = DEFAULT_GRID_COLS;
+        int rows = DEFAULT_GRID_ROWS;
 
+        // Per layer, tileChunkRows * tileChunkCols chunks (nullptr = empty)
+        std::vector<std::unique_ptr<TileChunk>> tiles[LAYER_COUNT];
+        int tileChunkCols = 0;
+        int tileChunkRows = 0;
+
+        // Terrain solidity, 1 bit per cell (1 = solid), solidWordsPerRow
+        // 64-bit words per row. PutTile() keeps it in sync cell by cell.
+        std::vector<Uint64> solidMask;
+        int solidWordsPerRow = 0;
+
+        // Needs a full save: changed in a way the journal doesn't hold
+        // (resize, SetCell(), ClearGrid())
+        bool dirty = false;
+
+        // Brush edits for undo/redo and the sidecar file
+        EditJournal journal;
+        size_t      journalRecordsOnDisk = 0;   // 0 = no sidecar file yet
+
+        Uint64 lastUsed = 0;   // LRU stamp (m_useCounter)
+    };
 
 private:
+    // Per level id; nullptr = not decoded (never loaded or evicted)
+    std::vector<std::shared_ptr<Level>> m_levels;
+    Level* m_level = nullptr;   // the active one
+
+    static const size_t DEFAULT_CACHE_BUDGET = 64 * 1024 * 1024;
+    size_t m_cacheBudget = DEFAULT_CACHE_BUDGET;
+    Uint64 m_useCounter = 0;
+
+    // Memory held by one decoded level
+    static size_t LevelBytes(const Level& level);
+
+    // Empty level of the default size in slot 'index'
+    Level& CreateLevel(int index);
+
+    void TouchLevel(Level& level) { level.lastUsed = ++m_useCounter; }
+
+    // Drop least recently used levels until the cache fits its budget
+    void EvictLevels();
+
+    // Prefetch worker, started on the first PrefetchLevel(). It decodes
+    // into a scratch LevelDesigner (the loaders work on m_level, which
+    // belongs to the sim thread) and hands the Level over.
+    std::thread             m_prefetchThread;
+    std::mutex              m_prefetchMutex;
+    std::condition_variable m_prefetchWake;     // new request or quit
+    std::condition_variable m_prefetchDone;     // a decode finished
+    int                     m_prefetchRequested = -1;   // waiting for the worker
+    std::string             m_prefetchPath;
+    TileProperties          m_prefetchTileProperties;
+    int                     m_prefetchLoading = -1;     // being decoded
+    std::shared_ptr<Level>  m_prefetchReady;            // decoded, not in the cache yet
+    int                     m_prefetchReadyIndex = -1;
+    bool                    m_prefetchQuit = false;
 
-    static const int MAX_LEVELS = 2;
+    void PrefetchMain();
 
-    std::string m_levelPaths[MAX_LEVELS];
-    int         m_activeLevelIndex = 0;
+    // Move a finished prefetch into the cache. waitForIndex >= 0 first
+    // waits for that level if it is still queued or decoding.
+    void AdoptPrefetched(int waitForIndex = -1);
 
-    struct Cell
+    // Level the layer caches were built for (render thread). A level
+    // switch (sim thread) only repoints m_level; the next snapshot then
+    // brings the new level and Render() rebuilds the caches.
+    LevelRef m_cachedLevel;
+
+    // Chunk holding (col, row), nullptr if none; no bounds check
+    static const TileChunk* TileChunkAt(const Level& level, TileLayer layer, int col, int row)
+    {
+        return level.tiles[static_cast<int>(layer)][(row >> TILE_CHUNK_SHIFT) * level.tileChunkCols + (col >> TILE_CHUNK_SHIFT)].get();
+    }
+
+    const TileChunk* TileChunkAt(TileLayer layer, int col, int row) const
+    {
+        return TileChunkAt(*m_level, layer, col, row);
+    }
+
+    TileId GetTile(TileLayer layer, int col, int row) const
     {
-        bool filled = false;
-        int  tileX = 0; // which tile column in the sheet (0-based)
-        int  tileY = 0; // which tile row in the sheet (0-based)
+        const TileChunk* chunk = TileChunkAt(layer, col, row);
+        return chunk ? chunk->tiles[(row & TILE_CHUNK_MASK) * TILE_CHUNK_CELLS + (col & TILE_CHUNK_MASK)] : EMPTY_TILE;
+    }
+
+    // Allocates the chunk on the first painted cell; no bounds check
+    void PutTile(TileLayer layer, int col, int row, TileId id);
+
+    // Drop every cell and size the chunk grid for the level's cols x rows
+    void ResetTiles();
+
+    // Load / save one level slot (path from the registry)
+    bool LoadLevel(int index);
+    bool SaveLevel(int index);
+
+    // Past this many journal records a save rewrites the whole level
+    // instead, so the sidecar (and replaying it on load) stays small
+    static const size_t JOURNAL_COMPACT_RECORDS = 65536;
+
+    static std::string JournalPath(const std::string& levelPath) { return levelPath + ".journal"; }
+
+    // Replay <level>.journal over the freshly loaded active level
+    void ReplayJournal(const std::string& levelPath);
+
+    // Put back the tiles of an undone (old) or redone (new) stroke
+    void ApplyEdits(const std::vector<EditRecord>& records, bool useOld);
+    std::vector<EditRecord> m_editScratch;
+
+    // Per tile type: solid, walkable, hazard, one-way
+    TileProperties m_tileProperties;
+
+    bool IsSolidTile(TileId id) const
+    {
+        return id == EMPTY_TILE || m_tileProperties.IsSolid(TileIdX(id), TileIdY(id));
+    }
+
+    void SetSolidBit(int col, int row, bool solid)
+    {
+        Uint64& word = m_level->solidMask[row * m_level->solidWordsPerRow + (col >> 6)];
+        Uint64 bit = Uint64(1) << (col & 63);
+        word = solid ? (word | bit) : (word & ~bit);
+    }
+
+    void RebuildSolidMask();
+
+    TextureHandle m_tileset;
+    int           m_tilesetW = 0;
+    int           m_tilesetH = 0;
+
+    // Each layer chunk is pre-composited into a render target; edits
+    // only redraw the dirty cells. Without render-target support the
+    // visible cells are drawn directly (one SDL_RenderGeometry call).
+    struct ChunkCache
+    {
+        SDL_Texture* target = nullptr;
+        SDL_Rect     dirty{ 0, 0, 0, 0 };  // in world cells, w == 0 = clean
+        bool         empty = false;        // known to hold no tiles (no texture)
     };
 
-    Cell m_grid[GRID_ROWS][GRID_COLS]{};
+    struct LayerCache
+    {
+        std::vector<ChunkCache> chunks;    // m_chunkRows * m_chunkCols
+        std::vector<int>        resident;  // chunk indices that own a texture
+    };
+
+    LayerCache m_layerCache[LAYER_COUNT];
+    int        m_chunkCols = 0;
+    int        m_chunkRows = 0;
+    bool       m_useChunkTargets = false;
+
+    // Tile quads being submitted (reused)
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int>        m_indices;
 
-    SDL_Texture* m_tileset = nullptr;
+    // Drop the layer caches and size them for 'level' (none = built by
+    // the next Render())
+    void ResetCaches(const LevelRef& level = LevelRef());
+    void ReleaseChunk(ChunkCache& chunk);
+    void MarkDirty(TileLayer layer, int col, int row, int cols, int rows);
+    void MarkAllDirty();
+
+    // Quads for cells in 'cells', positioned relative to (originX, originY)
+    void BuildMesh(const Level& level, TileLayer layer, const SDL_Rect& cells, int originX, int originY);
+    void UpdateChunk(SDL_Renderer* renderer, TileLayer layer, int chunkIndex);
+    void RenderLayer(SDL_Renderer* renderer, TileLayer layer, const SDL_Rect& view);
+
+    // Visible cell range for a view rect
+    static SDL_Rect VisibleCells(const Level& level, const SDL_Rect& view);
+
+    // Grid overlay as one polyline over the visible cells (paint mode only)
+    std::vector<SDL_Point> m_gridLinePoints;
+
+    void BuildGridLines(const SDL_Rect& view);
 
     // Current "brush" tile index in the spritesheet
     int m_selectedTileX = 0;
     int m_selectedTileY = 0;
 
+    // Layer the brush paints on (F5/F6/F7)
+    TileLayer m_activeLayer = TileLayer::Terrain;
+
     bool m_isPainting = false;
     bool m_isErasing = false;
 
-    // Apply brush to whatever cell is under (mouseX, mouseY)
-    void ApplyBrush(int mouseX, int mouseY, bool erase);
+    // Apply brush to whatever cell is under the world point (worldX, worldY)
+    void ApplyBrush(int worldX, int worldY, bool erase);
 
 };
 
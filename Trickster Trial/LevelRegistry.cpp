@@ -0,0 +1,182 @@
+#include "LevelRegistry.h"
+#include "AssetArchive.h"
+#include <fstream>
+#include <sstream>
+
+const char* LevelRegistry::DEFAULT_PATH = "assets/levels/levels.txt";
+
+LevelRegistry::LevelRegistry()
+{
+    SetDefaults();
+}
+
+void LevelRegistry::SetDefaults()
+{
+    m_levelPaths = { "assets/levels/level1.lvl", "assets/levels/level2.lvl" };
+    m_doors.clear();
+    m_cacheBudgetBytes = 0;
+    m_enemyLevel = 1;
+
+    // Both doors share the same on-screen position in their levels
+    DoorLink toLevel2;
+    toLevel2.fromLevel = 0;
+    toLevel2.toLevel = 1;
+    toLevel2.x = 1150.0f;
+    toLevel2.y = 260.0f;
+    toLevel2.targetX = 64.0f * 0.9f;
+    toLevel2.targetY = 64.0f * 4.5f;
+    m_doors.push_back(toLevel2);
+
+    DoorLink toLevel1;
+    toLevel1.fromLevel = 1;
+    toLevel1.toLevel = 0;
+    toLevel1.x = 50.0f;
+    toLevel1.y = 260.0f;
+    toLevel1.targetX = 64.0f * 17.5f;
+    toLevel1.targetY = 64.0f * 4.5f;
+    m_doors.push_back(toLevel1);
+
+    BuildDoorIndex();
+}
+
+bool LevelRegistry::LoadFromFile(const std::string& path)
+{
+    std::ifstream in(path);
+    if (in)
+        return LoadFromStream(in, path);
+
+    const AssetArchive::Entry* packed = AssetArchive::Instance().Find(path);
+    if (packed && packed->kind == AssetArchive::EntryKind::File)
+    {
+        std::istringstream packedIn(std::string(reinterpret_cast<const char*>(packed->data), packed->size));
+        return LoadFromStream(packedIn, path);
+    }
+
+    SDL_Log("LevelRegistry: no %s, using the built-in levels", path.c_str());
+    return false;
+}
+
+bool LevelRegistry::LoadFromStream(std::istream& in, const std::string& path)
+{
+    std::vector<std::string> levelPaths;
+    std::vector<DoorLink>    doors;
+    size_t                   cacheBudgetBytes = 0;
+    int                      enemyLevel = -1;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        std::istringstream fields(line);
+        std::string keyword;
+        if (!(fields >> keyword) || keyword.compare(0, 2, "//") == 0)
+            continue;
+
+        if (keyword == "level")
+        {
+            // Rest of the line, so paths may contain spaces
+            std::string levelPath;
+            std::getline(fields >> std::ws, levelPath);
+            while (!levelPath.empty() && (levelPath.back() == ' ' || levelPath.back() == '\t'))
+                levelPath.pop_back();
+
+            if (levelPath.empty())
+            {
+                SDL_Log("LevelRegistry: missing level path in %s (line %d)", path.c_str(), lineNumber);
+                return false;
+            }
+            levelPaths.push_back(levelPath);
+        }
+        else if (keyword == "door")
+        {
+            DoorLink door;
+            if (!(fields >> door.fromLevel >> door.x >> door.y >> door.toLevel >> door.targetX >> door.targetY))
+            {
+                SDL_Log("LevelRegistry: bad door in %s (line %d)", path.c_str(), lineNumber);
+                return false;
+            }
+            doors.push_back(door);
+        }
+        else if (keyword == "cache_mb")
+        {
+            int megabytes = 0;
+            if (!(fields >> megabytes) || megabytes <= 0)
+            {
+                SDL_Log("LevelRegistry: bad cache_mb in %s (line %d)", path.c_str(), lineNumber);
+                return false;
+            }
+            cacheBudgetBytes = static_cast<size_t>(megabytes) * 1024 * 1024;
+        }
+        else if (keyword == "enemies")
+        {
+            if (!(fields >> enemyLevel))
+            {
+                SDL_Log("LevelRegistry: bad enemies in %s (line %d)", path.c_str(), lineNumber);
+                return false;
+            }
+        }
+        else
+        {
+            SDL_Log("LevelRegistry: unknown entry '%s' in %s (line %d)", keyword.c_str(), path.c_str(), lineNumber);
+            return false;
+        }
+    }
+
+    if (levelPaths.empty())
+    {
+        SDL_Log("LevelRegistry: no levels in %s", path.c_str());
+        return false;
+    }
+
+    // Doors may be listed before the levels they use: check at the end
+    const int levelCount = static_cast<int>(levelPaths.size());
+    for (const DoorLink& door : doors)
+    {
+        if (door.fromLevel < 0 || door.fromLevel >= levelCount || door.toLevel < 0 || door.toLevel >= levelCount)
+        {
+            SDL_Log("LevelRegistry: door %d -> %d in %s uses an unknown level", door.fromLevel, door.toLevel, path.c_str());
+            return false;
+        }
+    }
+
+    if (enemyLevel < -1 || enemyLevel >= levelCount)
+    {
+        SDL_Log("LevelRegistry: enemies in unknown level %d in %s", enemyLevel, path.c_str());
+        return false;
+    }
+
+    m_levelPaths.swap(levelPaths);
+    m_doors.swap(doors);
+    m_cacheBudgetBytes = cacheBudgetBytes;
+    m_enemyLevel = enemyLevel;
+    BuildDoorIndex();
+
+    SDL_Log("LevelRegistry: %d levels, %d doors from %s",
+        GetLevelCount(), static_cast<int>(m_doors.size()), path.c_str());
+    return true;
+}
+
+void LevelRegistry::BuildDoorIndex()
+{
+    m_doorsByLevel.assign(m_levelPaths.size(), std::vector<int>());
+    for (size_t i = 0; i < m_doors.size(); ++i)
+        m_doorsByLevel[m_doors[i].fromLevel].push_back(static_cast<int>(i));
+}
+
+int LevelRegistry::FindDoor(int fromLevel, int toLevel) const
+{
+    if (fromLevel < 0 || fromLevel >= GetLevelCount())
+        return -1;
+
+    for (int door : m_doorsByLevel[fromLevel])
+    {
+        if (m_doors[door].toLevel == toLevel)
+            return door;
+    }
+    return -1;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <SDL.h>
+#include <istream>
+#include <string>
+#include <vector>
+
+// Which levels exist and how their doors connect them, loaded from a
+// text manifest (assets/levels/levels.txt). Levels are the nodes of a
+// graph, doors its (one-way) edges; a door pair is just two edges.
+class LevelRegistry
+{
+public:
+    static const char* DEFAULT_PATH;
+
+    // One door: stands in 'fromLevel' and leads to 'toLevel'
+    struct DoorLink
+    {
+        int   fromLevel = 0;
+        int   toLevel = 0;
+        float x = 0.0f;         // door position in fromLevel
+        float y = 0.0f;
+        float targetX = 0.0f;   // where the player comes out in toLevel
+        float targetY = 0.0f;
+    };
+
+    LevelRegistry();
+
+    // File format, one entry per line ("//" starts a comment line):
+    //   level <path>                             levels get ids 0, 1, ... in order
+    //   door <from> <x> <y> <to> <spawnX> <spawnY>
+    //   cache_mb <megabytes>                     budget for decoded levels
+    //   enemies <level>                          level the pigs live in
+    // Loose file first, then the asset archive.
+    bool LoadFromFile(const std::string& path);
+
+    // Built-in campaign: level1 <-> level2 (used when the file is missing)
+    void SetDefaults();
+
+    int GetLevelCount() const { return static_cast<int>(m_levelPaths.size()); }
+    const std::string& GetLevelPath(int level) const { return m_levelPaths[level]; }
+
+    const std::vector<DoorLink>& GetDoors() const { return m_doors; }
+
+    // Indices into GetDoors() of the doors standing in a level
+    const std::vector<int>& GetDoorsIn(int level) const { return m_doorsByLevel[level]; }
+
+    // First door in 'fromLevel' leading to 'toLevel', -1 if none
+    int FindDoor(int fromLevel, int toLevel) const;
+
+    // 0 = not set in the manifest
+    size_t GetCacheBudgetBytes() const { return m_cacheBudgetBytes; }
+
+    // Level holding the King Pig and his minions, -1 = none
+    int GetEnemyLevel() const { return m_enemyLevel; }
+
+private:
+    bool LoadFromStream(std::istream& in, const std::string& path);
+    void BuildDoorIndex();
+
+    std::vector<std::string>      m_levelPaths;
+    std::vector<DoorLink>         m_doors;
+    std::vector<std::vector<int>> m_doorsByLevel;
+    size_t                        m_cacheBudgetBytes = 0;
+    int                           m_enemyLevel = -1;
+};
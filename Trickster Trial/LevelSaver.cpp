@@ -0,0 +1,225 @@
+#include "LevelSaver.h"
+#include <cstdio>
+#include <system_error>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+LevelSaver::~LevelSaver()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+
+    // Run() drains the queue before it returns
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void LevelSaver::Queue(const std::string& path, std::vector<Uint8> bytes)
+{
+    Push(JobKind::Replace, path, std::move(bytes));
+}
+
+void LevelSaver::QueueAppend(const std::string& path, std::vector<Uint8> bytes)
+{
+    Push(JobKind::Append, path, std::move(bytes));
+}
+
+void LevelSaver::QueueRemove(const std::string& path)
+{
+    Push(JobKind::Remove, path, std::vector<Uint8>());
+}
+
+void LevelSaver::Push(JobKind kind, const std::string& path, std::vector<Uint8> bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Merge with the last waiting job only: merging with an older one
+        // would reorder it around the jobs queued since
+        Job* last = m_jobs.empty() ? nullptr : &m_jobs.back();
+        if (last && last->path == path && last->kind == kind && kind != JobKind::Remove)
+        {
+            if (kind == JobKind::Replace)
+                last->bytes.swap(bytes);
+            else
+                last->bytes.insert(last->bytes.end(), bytes.begin(), bytes.end());
+        }
+        else
+        {
+            Job job;
+            job.kind = kind;
+            job.path = path;
+            job.bytes = std::move(bytes);
+            m_jobs.push_back(std::move(job));
+        }
+
+        if (!m_thread.joinable())
+        {
+            try
+            {
+                m_thread = std::thread(&LevelSaver::Run, this);
+            }
+            catch (const std::system_error&)
+            {
+                SDL_Log("LevelSaver: no I/O thread, saving %s on this thread", path.c_str());
+            }
+        }
+    }
+
+    if (m_thread.joinable())
+    {
+        m_wake.notify_one();
+        return;
+    }
+
+    // No thread: write synchronously rather than lose the edit
+    std::deque<Job> jobs;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        jobs.swap(m_jobs);
+    }
+    for (const Job& job : jobs)
+    {
+        if (!RunJob(job))
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_failed;
+        }
+    }
+}
+
+void LevelSaver::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_jobs.empty() && !m_writing; });
+}
+
+int LevelSaver::GetFailedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failed;
+}
+
+void LevelSaver::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (;;)
+    {
+        m_wake.wait(lock, [this]() { return m_quit || !m_jobs.empty(); });
+
+        if (m_jobs.empty())
+            break; // quit, nothing left to write
+
+        Job job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_writing = true;
+
+        lock.unlock();
+        bool ok = RunJob(job);
+        lock.lock();
+
+        if (!ok)
+            ++m_failed;
+
+        m_writing = false;
+        if (m_jobs.empty())
+            m_idle.notify_all();
+    }
+}
+
+bool LevelSaver::RunJob(const Job& job)
+{
+    switch (job.kind)
+    {
+    case JobKind::Replace:
+        return WriteFileAtomic(job.path, job.bytes);
+    case JobKind::Append:
+        return AppendFile(job.path, job.bytes);
+    case JobKind::Remove:
+        // Nothing to remove is fine too
+        std::remove(job.path.c_str());
+        return true;
+    }
+    return false;
+}
+
+bool LevelSaver::AppendFile(const std::string& path, const std::vector<Uint8>& bytes)
+{
+    FILE* file = std::fopen(path.c_str(), "ab");
+    if (!file)
+    {
+        SDL_Log("LevelSaver: failed to open %s for appending", path.c_str());
+        return false;
+    }
+
+    bool ok = bytes.empty() || std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    ok = ok && std::fflush(file) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok)
+        SDL_Log("LevelSaver: failed to append to %s", path.c_str());
+    return ok;
+}
+
+bool LevelSaver::WriteFileAtomic(const std::string& path, const std::vector<Uint8>& bytes)
+{
+    const std::string tempPath = path + ".tmp";
+
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file)
+    {
+        SDL_Log("LevelSaver: failed to open %s for writing", tempPath.c_str());
+        return false;
+    }
+
+    bool ok = bytes.empty() || std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    ok = ok && std::fflush(file) == 0;
+
+    // Make sure the data is on the device before the rename makes it live
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok)
+    {
+        SDL_Log("LevelSaver: failed to write %s", tempPath.c_str());
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    ok = MoveFileExA(tempPath.c_str(), path.c_str(),
+        MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    ok = std::rename(tempPath.c_str(), path.c_str()) == 0;
+#endif
+
+    if (!ok)
+    {
+        SDL_Log("LevelSaver: failed to replace %s", path.c_str());
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    return true;
+}
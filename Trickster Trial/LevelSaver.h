@@ -0,0 +1,74 @@
+#pragma once
+
+#include <SDL.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes level files on a background thread so the editor never waits
+// for the disk. Every write goes to "<path>.tmp", is flushed to the
+// device and then renamed over the real file: a crash mid-save leaves
+// the old file or the new one, never a truncated mix.
+class LevelSaver
+{
+public:
+    LevelSaver() = default;
+    ~LevelSaver();  // finishes everything queued
+
+    LevelSaver(const LevelSaver&) = delete;
+    LevelSaver& operator=(const LevelSaver&) = delete;
+
+    // Queue a serialized level. A snapshot of the same path that is
+    // still waiting at the end of the queue is replaced (only the newest
+    // matters).
+    void Queue(const std::string& path, std::vector<Uint8> bytes);
+
+    // Append to a file (edit journals), flushed to the device like the
+    // full writes. Jobs run in queue order, so an append queued after a
+    // remove of the same file starts a fresh one.
+    void QueueAppend(const std::string& path, std::vector<Uint8> bytes);
+    void QueueRemove(const std::string& path);
+
+    // Block until everything queued so far is on disk
+    void Flush();
+
+    // Writes that failed since the start (logged as they happen)
+    int GetFailedCount() const;
+
+    // The same temp + flush + rename write, on the calling thread
+    static bool WriteFileAtomic(const std::string& path, const std::vector<Uint8>& bytes);
+    static bool AppendFile(const std::string& path, const std::vector<Uint8>& bytes);
+
+private:
+    enum class JobKind
+    {
+        Replace,
+        Append,
+        Remove
+    };
+
+    struct Job
+    {
+        JobKind            kind = JobKind::Replace;
+        std::string        path;
+        std::vector<Uint8> bytes;
+    };
+
+    void Push(JobKind kind, const std::string& path, std::vector<Uint8> bytes);
+    static bool RunJob(const Job& job);
+
+    void Run();
+
+    std::thread m_thread;   // started on the first Queue()
+
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_wake;      // new job or quit
+    std::condition_variable m_idle;      // queue drained
+    std::deque<Job>         m_jobs;
+    bool                    m_writing = false;
+    bool                    m_quit = false;
+    int                     m_failed = 0;
+};
@@ -2,26 +2,311 @@
 #include <SDL_image.h>
 #include <iostream>
 #include <string>
-#include <cmath>
-#include <vector>
-
-#include "TextureManager.h"
-#include "LevelDesigner.h"
-#include "Character.h"
-#include "Door.h"
-#include "Enemy.h"
-#include "DialogueBox.h"
-
-// Teleport state when using doors
-enum class DoorTravelState
+#include <cstdlib>
+#include <cstring>
+
+#include "Game.h"
+#include "Replay.h"
+#include "Profiler.h"
+#include "Benchmark.h"
+#include "RenderSnapshot.h"
+#include "SimulationThread.h"
+#include "AssetArchive.h"
+
+namespace
 {
-    None,
-    GoingIn,
-    ComingOut
-};
+    // Scripted "monkey" input for headless soak runs.
+    // Holds a random direction for a while (drifting right, towards the
+    // door and the pigs), sometimes presses F or attacks.
+    // Same seed = same input sequence.
+    struct SoakInput
+    {
+        Uint32 rng = 1;
+        int holdTicks = 0;
+        PlayerInput held;
+
+        Uint32 Next()
+        {
+            // xorshift32
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            return rng;
+        }
+
+        PlayerInput NextTick()
+        {
+            if (holdTicks <= 0)
+            {
+                Uint32 r = Next();
+                held = PlayerInput();
+                held.right = (r & 0x3) <= 1;
+                held.left = (r & 0x3) == 2;
+                held.up = ((r >> 2) & 0x3) == 0;
+                held.down = ((r >> 2) & 0x3) == 1;
+                held.door = ((r >> 4) & 0x7) == 0;
+                holdTicks = 30 + static_cast<int>((r >> 8) % 150); // 0.25s - 1.5s
+            }
+            --holdTicks;
+
+            PlayerInput input = held;
+            input.attackPresses = (Next() % 40 == 0) ? 1 : 0;
+            return input;
+        }
+    };
+
+    // Command line options
+    struct LaunchOptions
+    {
+        bool        headless = false;
+        int         ticks = 120 * 60;   // one minute of game time
+        Uint32      seed = 1;
+        std::string recordPath;         // write input + state hashes
+        std::string replayPath;         // play back + verify (headless)
+        std::string profileCsvPath;     // frame profile summary on exit
+        bool        bench = false;      // run microbenchmarks and exit
+        std::string benchFilter;
+        std::string benchFormat = "text";
+        bool        packAssets = false; // build the asset archive and exit
+        std::string packPath = AssetArchive::DEFAULT_PATH;
+        std::string convertIn;          // convert a level file and exit
+        std::string convertOut;
+    };
+
+    // Offline: level file in either format -> binary, or -> text when
+    // the output ends in ".map" (for diffs)
+    int RunConvertLevel(const LaunchOptions& options)
+    {
+        LevelDesigner level;
+        level.autoSaveEnabled = false;
+
+        if (!level.LoadFromFile(options.convertIn))
+        {
+            std::cout << "Failed to load level " << options.convertIn << "\n";
+            return 1;
+        }
+
+        const std::string& out = options.convertOut;
+        bool toText = out.size() >= 4 && out.compare(out.size() - 4, 4, ".map") == 0;
+
+        bool ok = toText ? level.ExportText(out) : level.SaveToFile(out);
+        std::cout << (ok ? "Wrote " : "Failed to write ") << out << " ("
+            << level.GetCols() << "x" << level.GetRows() << ")\n";
+        return ok ? 0 : 1;
+    }
+
+    // Offline: decode every asset once into the archive the game maps
+    int RunPackAssets(const LaunchOptions& options)
+    {
+        if (SDL_Init(0) != 0)
+        {
+            std::cout << "SDL_Init Error: " << SDL_GetError() << "\n";
+            return 1;
+        }
+        IMG_Init(IMG_INIT_PNG);
+
+        bool ok = AssetArchive::Pack({ "assets/anim", "assets/textures", "assets/levels" }, options.packPath);
+
+        IMG_Quit();
+        SDL_Quit();
+        return ok ? 0 : 1;
+    }
+
+    // Progress bar shown while sprite sheets decode
+    void RenderLoadingScreen(SDL_Renderer* renderer, float progress)
+    {
+        int w = 0, h = 0;
+        SDL_GetRendererOutputSize(renderer, &w, &h);
+
+        SDL_SetRenderDrawColor(renderer, 30, 30, 30, 255);
+        SDL_RenderClear(renderer);
+
+        SDL_Rect frame{ w / 4, h / 2 - 8, w / 2, 16 };
+        SDL_Rect fill{ frame.x + 2, frame.y + 2, static_cast<int>((frame.w - 4) * progress), frame.h - 4 };
+
+        SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
+        SDL_RenderDrawRect(renderer, &frame);
+        SDL_RenderFillRect(renderer, &fill);
+
+        SDL_RenderPresent(renderer);
+    }
+
+    // Headless soak/benchmark run: full game logic, no window,
+    // no texture uploads and no present.
+    // Input comes from the soak script, or from a replay file.
+    int RunHeadless(const LaunchOptions& options)
+    {
+        if (SDL_Init(SDL_INIT_TIMER) != 0)
+        {
+            std::cout << "SDL_Init Error: " << SDL_GetError() << "\n";
+            return 1;
+        }
+
+        Game game;
+        if (!game.Init(nullptr))
+        {
+            std::cout << "Failed to init game (headless)\n";
+            SDL_Quit();
+            return 1;
+        }
+        game.SetWaitForLevels(true);
+
+        ReplayReader replay;
+        const bool replaying = !options.replayPath.empty();
+        if (replaying)
+        {
+            if (!replay.Open(options.replayPath))
+            {
+                SDL_Quit();
+                return 1;
+            }
+
+            if (SDL_fabs(replay.GetStepSeconds() - game.GetClock().GetStepSeconds()) > 1e-6)
+                std::cout << "Warning: replay was recorded with a different tick rate\n";
+        }
+
+        ReplayWriter recorder;
+        if (!options.recordPath.empty() && !recorder.Open(options.recordPath, game.GetClock().GetStepSeconds()))
+        {
+            SDL_Quit();
+            return 1;
+        }
+
+        SoakInput soak;
+        soak.rng = options.seed ? options.seed : 1;
+
+        int tickCount = 0;
+        long long firstDivergence = -1;
+
+        Uint64 start = SDL_GetPerformanceCounter();
+
+        while (replaying || tickCount < options.ticks)
+        {
+            PlayerInput input;
+            Uint32 expectedHash = 0;
+
+            if (replaying)
+            {
+                if (!replay.ReadTick(input, expectedHash))
+                    break;
+            }
+            else
+            {
+                input = soak.NextTick();
+            }
+
+            Profiler::Instance().BeginFrame();
+            game.Tick(input);
+            Profiler::Instance().EndFrame();
+            ++tickCount;
+
+            if (replaying || recorder.IsOpen())
+            {
+                Uint32 hash = game.HashState();
+
+                if (replaying && hash != expectedHash && firstDivergence < 0)
+                    firstDivergence = tickCount - 1;
+
+                recorder.WriteTick(input, hash);
+            }
+        }
+
+        Uint64 end = SDL_GetPerformanceCounter();
+        recorder.Close();
+
+        if (!options.profileCsvPath.empty())
+            Profiler::Instance().WriteCsv(options.profileCsvPath);
+        double seconds = static_cast<double>(end - start) / static_cast<double>(SDL_GetPerformanceFrequency());
+
+        std::cout << "Headless: " << tickCount << " ticks in " << seconds * 1000.0 << " ms ("
+            << (seconds > 0.0 ? tickCount / seconds : 0.0) << " ticks/s)\n";
+        std::cout << "  player level " << game.GetPlayerLevel() + 1
+            << ", health " << game.GetPlayer().GetHealth()
+            << ", pigs dead " << game.GetDeadPigCount()
+            << ", king dead " << (game.IsKingPigDead() ? "yes" : "no")
+            << ", door prefetch misses " << game.GetDoorPrefetchMisses() << "\n";
+
+        SDL_Quit();
+
+        if (replaying)
+        {
+            if (firstDivergence >= 0)
+            {
+                std::cout << "Replay DIVERGED at tick " << firstDivergence << "\n";
+                return 2;
+            }
+
+            std::cout << "Replay OK: all " << tickCount << " ticks match\n";
+        }
+
+        return 0;
+    }
+}
 
 int main(int argc, char* argv[])
 {
+    // Command line:
+    //   --headless      run the simulation without window/renderer
+    //   --ticks N       number of sim ticks for the headless run
+    //   --seed S        seed for the headless input script
+    //   --record FILE   record input + per-tick state hashes
+    //   --replay FILE   replay a recording headless and report divergence
+    //   --profile-csv FILE   write per-phase frame time percentiles on exit
+    //   --bench [--bench-filter TEXT] [--bench-format text|csv|json]
+    //   --pack-assets [FILE] build the asset archive (default assets.pak)
+    //   --convert-level IN OUT   .map/.lvl -> .lvl, or -> text if OUT is .map
+
+    LaunchOptions options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--headless") == 0)
+            options.headless = true;
+        else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+            options.ticks = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            options.seed = static_cast<Uint32>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            options.recordPath = argv[++i];
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            options.replayPath = argv[++i];
+        else if (std::strcmp(argv[i], "--profile-csv") == 0 && i + 1 < argc)
+            options.profileCsvPath = argv[++i];
+        else if (std::strcmp(argv[i], "--bench") == 0)
+            options.bench = true;
+        else if (std::strcmp(argv[i], "--bench-filter") == 0 && i + 1 < argc)
+            options.benchFilter = argv[++i];
+        else if (std::strcmp(argv[i], "--bench-format") == 0 && i + 1 < argc)
+            options.benchFormat = argv[++i];
+        else if (std::strcmp(argv[i], "--pack-assets") == 0)
+        {
+            options.packAssets = true;
+            if (i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0)
+                options.packPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--convert-level") == 0 && i + 2 < argc)
+        {
+            options.convertIn = argv[++i];
+            options.convertOut = argv[++i];
+        }
+    }
+
+    if (options.bench)
+        return RunBenchmarks(options.benchFilter, options.benchFormat);
+
+    if (options.packAssets)
+        return RunPackAssets(options);
+
+    if (!options.convertIn.empty())
+        return RunConvertLevel(options);
+
+    // Pre-decoded assets if packed, loose files otherwise
+    if (!AssetArchive::Instance().Open(AssetArchive::DEFAULT_PATH))
+        std::cout << "No asset archive, loading loose files\n";
+
+    if (options.headless || !options.replayPath.empty())
+        return RunHeadless(options);
+
     // SDL/window/renderer setup
 
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) != 0)
@@ -65,117 +350,34 @@ int main(int argc, char* argv[])
         return 1;
     }
 
-    // Level tiles
-
-    LevelDesigner levelDesigner;
-    if (!levelDesigner.Init(renderer))
-    {
-        std::cout << "Failed to init LevelDesigner\n";
-        SDL_DestroyRenderer(renderer);
-        SDL_DestroyWindow(window);
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
-    }
-
-    // Disable paint mode by default (F1/F2 to edit levels)
-    levelDesigner.paintingEnabled = false;
-
-    // Player
-
-    Character player;
-    if (!player.Init(renderer))
-    {
-        std::cout << "Failed to init Character\n";
-        SDL_DestroyRenderer(renderer);
-        SDL_DestroyWindow(window);
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
-    }
-
-    // Start in Level 1
-    player.SetPosition(5.0f, 280.0f);
-    int playerLevelIndex = 0; // 0 = level1, 1 = level2
-
-    // Doors (tunnel between levels)
-
-    Door doorLevel0To1;
-    Door doorLevel1To0;
-    std::string doorFolder = "assets/anim/Door";
+    // Game world
 
-    if (!doorLevel0To1.Init(renderer,doorFolder) ||
-        !doorLevel1To0.Init(renderer,doorFolder))
-    {
-        std::cout << "Failed to init Door(s)\n";
-        SDL_DestroyRenderer(renderer);
-        SDL_DestroyWindow(window);
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
-    }
-
-    // Both doors share the same on-screen position in their levels
-    doorLevel0To1.SetPosition(1150, 260.0f); // Level 0 door → Level 1
-    doorLevel1To0.SetPosition(50, 260.0f); // Level 1 door → Level 0
-
-    // Where the player appears after using each door
-    doorLevel0To1.SetTravelTarget(
-        0, 1,
-        64.0f * 0.9f,   // spawn in level 2
-        64.0f * 4.5f);
-
-    doorLevel1To0.SetTravelTarget(
-        1, 0,
-        64.0f * 17.5f,  // spawn in level 1
-        64.0f * 4.5f);
-
-    // Enemies 
-
-    Enemy kingPig;
-    if (!kingPig.InitKingPig(renderer, "assets/anim/King Pig"))
-    {
-        std::cout << "Failed to init King Pig\n";
-        SDL_DestroyRenderer(renderer);
-        SDL_DestroyWindow(window);
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
-    }
-
-    // King is in Level 2 (right side)
-    kingPig.SetPosition(1170.0f, 280.0f);
-
-    // Minion pigs (all live in Level 2)
-    std::vector<Enemy> minionPigs;
-    const int MINION_COUNT = 3;
-    minionPigs.resize(MINION_COUNT);
+    Game game;
+    bool running = true;
 
-    for (int i = 0; i < MINION_COUNT; ++i)
+    bool loaded = game.Init(renderer);
+    if (loaded)
     {
-        if (!minionPigs[i].InitPig(renderer, "assets/anim/Pig"))
+        // Sprite sheets decode on worker threads; keep the window
+        // responsive with a progress bar until they can be uploaded
+        while (!game.IsLoadingDone())
         {
-            std::cout << "Failed to init Minion Pig " << i << "\n";
-            SDL_DestroyRenderer(renderer);
-            SDL_DestroyWindow(window);
-            IMG_Quit();
-            SDL_Quit();
-            return 1;
+            SDL_Event loadEvent;
+            while (SDL_PollEvent(&loadEvent))
+            {
+                if (loadEvent.type == SDL_QUIT)
+                    running = false;
+            }
+
+            RenderLoadingScreen(renderer, game.GetLoadingProgress());
+            SDL_Delay(1);
         }
     }
 
-    // Initial positions for pigs
-    minionPigs[0].SetPosition(600.0f, 20.0f);   
-    minionPigs[1].SetPosition(600.0f, 610.0f);   
-    minionPigs[2].SetPosition(1000.0f, 280.0f);  
-
-    // UI:Life bar
-
-    SDL_Texture* liveBarTex = TextureManager::Instance().LoadTexture("assets/anim/Live and Coins/Live Bar.png",renderer);
-
-    if (!liveBarTex)
+    loaded = loaded && game.FinishLoading(renderer);
+    if (!loaded)
     {
-        std::cout << "Failed to load Live Bar UI\n";
+        std::cout << "Failed to init game\n";
         SDL_DestroyRenderer(renderer);
         SDL_DestroyWindow(window);
         IMG_Quit();
@@ -183,502 +385,97 @@ int main(int argc, char* argv[])
         return 1;
     }
 
-    const int LIVE_BAR_FULL_W = 66;
-    const int LIVE_BAR_H = 34;
-    const int HEART_W = LIVE_BAR_FULL_W / 3; // 3 hearts
+    // Frame profiler overlay (F3)
+    Profiler& profiler = Profiler::Instance();
+    if (!profiler.InitOverlay(renderer))
+        std::cout << "Profiler overlay digits not available\n";
 
-    // King Pig dialogue
+    ReplayWriter recorder;
+    if (!options.recordPath.empty())
+        recorder.Open(options.recordPath, game.GetClock().GetStepSeconds());
+    game.SetWaitForLevels(recorder.IsOpen());
 
-    DialogueBox kingPigDialogue;
-    if (!kingPigDialogue.Init(renderer, "assets/anim/Dialogue Boxes"))
-    {
-        std::cout << "Failed to init King Pig dialogue\n";
-        SDL_DestroyRenderer(renderer);
-        SDL_DestroyWindow(window);
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
-    }
-
-    bool kingPigDialogueStarted = false;
-    bool minionChaseUnlocked = false; // minions wait for dialogue
-    Uint32 minionChaseUnlockStart = 0;     // when we started 0.5s timer
+    // Simulation runs on its own thread; this thread handles events and
+    // draws the latest snapshot
+    SimulationThread sim(game, recorder.IsOpen() ? &recorder : nullptr);
+    sim.Start();
 
-    // King Pig wake-up when minion dies or player gets close
-    bool kingPigAwake = false;
-    float kingPigWakeRadius = 220.0f; // radius from king center
+    RenderSnapshot snapshot;
 
-    // Teleport state
-
-    bool running = true;
     SDL_Event e;
-    Uint32 lastTicks = SDL_GetTicks();
-    DoorTravelState travelState = DoorTravelState::None;
-    Uint32 travelStartTime = 0;
-    Door* activeDoor = nullptr;
-
-    bool fWasDown = false; // for detecting fresh F press
-
-    // Helper: check if player is within radius of a door
-    auto IsPlayerNearDoor = [&](const Character& p, const Door& d) -> bool
-        {
-            SDL_FRect doorRect = d.GetBounds();
-
-            float px = p.GetX() + p.GetWidth() * 0.5f;
-            float py = p.GetY() + p.GetHeight() * 0.5f;
-
-            float dx = px - (doorRect.x + doorRect.w * 0.5f);
-            float dy = py - (doorRect.y + doorRect.h * 0.5f);
-
-            float distSq = dx * dx + dy * dy;
-            float maxDist = 80.0f;
-            float maxDistSq = maxDist * maxDist;
-
-            return distSq <= maxDistSq;
-        };
-
-    // Helper: simple AABB overlap
-    auto RectsOverlap = [](const SDL_FRect& a, const SDL_FRect& b) -> bool
-        {
-            return !(a.x + a.w <= b.x ||
-                b.x + b.w <= a.x ||
-                a.y + a.h <= b.y ||
-                b.y + b.h <= a.y);
-        };
 
     // GAME LOOP
 
     while (running)
     {
-        // Delta time 
-        Uint32 now = SDL_GetTicks();
-        float dt = (now - lastTicks) / 1000.0f;
-        lastTicks = now;
+        profiler.BeginFrame();
 
         // Events 
-        while (SDL_PollEvent(&e))
         {
-            if (e.type == SDL_QUIT)
-                running = false;
+            ScopedTimer timer(ProfilePhase::Events);
 
-            // Left mouse button triggers attack
-            if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT)
+            while (SDL_PollEvent(&e))
             {
-                player.SetState(AnimState::Attack);
-            }
-
-            levelDesigner.HandleEvent(e);
-        }
-
-        // Update door animation frames
-        doorLevel0To1.Update();
-        doorLevel1To0.Update();
-
-        // Keyboard state each frame
-        const Uint8* keystate = SDL_GetKeyboardState(nullptr);
-        float speed = 180.0f; // player move speed (pixels/s)
+                if (e.type == SDL_QUIT)
+                    running = false;
 
-        float dx = 0.0f;
-        float dy = 0.0f;
-
-        //  PLAYER CONTROL/AI/COMBAT (when NOT teleporting)
-        if (travelState == DoorTravelState::None)
-        {
-            // Player movement & door interaction
-            if (levelDesigner.GetActiveLevel() == playerLevelIndex)
-            {
-                if (!player.IsDead())
+                // Left mouse button triggers attack
+                if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT)
                 {
-                    // WASD movement
-                    if (keystate[SDL_SCANCODE_A] || keystate[SDL_SCANCODE_LEFT])
-                        dx -= speed * dt;
-                    if (keystate[SDL_SCANCODE_D] || keystate[SDL_SCANCODE_RIGHT])
-                        dx += speed * dt;
-                    if (keystate[SDL_SCANCODE_W] || keystate[SDL_SCANCODE_UP])
-                        dy -= speed * dt;
-                    if (keystate[SDL_SCANCODE_S] || keystate[SDL_SCANCODE_DOWN])
-                        dy += speed * dt;
-
-                    if (dx != 0.0f || dy != 0.0f)
-                    {
-                        player.MoveWithCollision(dx, dy, levelDesigner);
-                        player.SetState(AnimState::Run);
-                    }
-                    else
-                    {
-                        player.SetState(AnimState::Idle);
-                    }
-
-                    // Door interaction (press F near door)
-                    bool fDown = keystate[SDL_SCANCODE_F];
-
-                    if (fDown && !fWasDown)
-                    {
-                        Door* candidateDoor = nullptr;
-                        if (playerLevelIndex == 0)
-                            candidateDoor = &doorLevel0To1;
-                        else if (playerLevelIndex == 1)
-                            candidateDoor = &doorLevel1To0;
-
-                        if (candidateDoor && IsPlayerNearDoor(player, *candidateDoor))
-                        {
-                            activeDoor = candidateDoor;
-                            travelState = DoorTravelState::GoingIn;
-                            travelStartTime = now;
-
-                            activeDoor->SetState(DoorAnimState::Opening);
-                            player.SetState(AnimState::DoorIn);
-                        }
-                    }
-
-                    fWasDown = fDown;
+                    sim.AddAttackPress();
                 }
-                else
-                {
-                    // Dead: no movement / no door usage
-                    dx = dy = 0.0f;
-                    fWasDown = keystate[SDL_SCANCODE_F];
-                }
-            }
-
-            // Dialogue + AI timing
 
-            kingPigDialogue.Update();
-
-            // Minions start chasing 0.5s AFTER dialogue finishes
-            if (!minionChaseUnlocked && kingPigDialogueStarted && kingPigDialogue.IsFinished())
-            {
-                if (minionChaseUnlockStart == 0)
-                    minionChaseUnlockStart = now;
-                else if (now - minionChaseUnlockStart >= 500) // 0.5 seconds
-                    minionChaseUnlocked = true;
-            }
-
-            // Enemy AI only when in Level 2
-            if (levelDesigner.GetActiveLevel() == 1)
-            {
-                // Minion pigs
-                for (size_t i = 0; i < minionPigs.size(); ++i)
-                {
-                    Enemy& pig = minionPigs[i];
-
-                    if (!minionChaseUnlocked)
-                    {
-                        if (!pig.IsDead())
-                            pig.SetState(EnemyAnimState::Idle);
-                        continue;
-                    }
-
-                    // No movement while stunned or dead
-                    if (pig.IsDead() || pig.IsStunned())
-                        continue;
-
-                    // Centers
-                    float playerCenterX = player.GetX() + player.GetWidth() * 0.5f;
-                    float playerCenterY = player.GetY() + player.GetHeight() * 0.5f;
-                    float pigCenterX = pig.GetX() + pig.GetWidth() * 0.5f;
-                    float pigCenterY = pig.GetY() + pig.GetHeight() * 0.5f;
-
-                    // Always face the player
-                    pig.SetFacingRight(playerCenterX > pigCenterX);
-
-                    // Melee attack range 
-                    const float ATTACK_RANGE = 30.0f; // distance from pig center
-                    const float VERT_TOLERANCE = 16.0f; // vertical leniency
-
-                    float dxAttack = playerCenterX - pigCenterX;
-                    float dyAttack = playerCenterY - pigCenterY;
-                    float distSqAttack = dxAttack * dxAttack + dyAttack * dyAttack;
-
-                    if (distSqAttack <= ATTACK_RANGE * ATTACK_RANGE &&
-                        std::abs(dyAttack) <= VERT_TOLERANCE &&
-                        !player.IsDead())
-                    {
-                        // In melee range = attack animation + damage
-                        pig.SetState(EnemyAnimState::Attack);
-                        player.ApplyDamage(1);
-                        continue; // skip movement this frame
-                    }
-
-                    // Surrounding behaviour (offset per pig index)
-                    float offsetX = 0.0f;
-                    float offsetY = 0.0f;
-
-                    if (i == 0) offsetX = -40.0f; // left
-                    if (i == 1) offsetX = 40.0f; // right
-                    if (i == 2) offsetY = -40.0f; // top
-                    if (i == 3) offsetY = 40.0f; // bottom
-
-                    float targetX = playerCenterX + offsetX;
-                    float targetY = playerCenterY + offsetY;
-
-                    float dirX = targetX - pigCenterX;
-                    float dirY = targetY - pigCenterY;
-                    float lenSq = dirX * dirX + dirY * dirY;
-
-                    if (lenSq > 1.0f)
-                    {
-                        float len = std::sqrt(lenSq);
-                        dirX /= len;
-                        dirY /= len;
-
-                        float moveX = dirX * 120.0f * dt;
-                        float moveY = dirY * 120.0f * dt;
-
-                        pig.SetState(EnemyAnimState::Run);
-                        pig.MoveWithCollision(moveX, moveY, levelDesigner);
-                    }
-                    else
-                    {
-                        pig.SetState(EnemyAnimState::Idle);
-                    }
-                }
-
-                // King Pig
-
-                // Check if any minion is dead
-                bool anyMinionDead = false;
-                for (const Enemy& pig : minionPigs)
-                {
-                    if (pig.GetState() == EnemyAnimState::Dead)
-                    {
-                        anyMinionDead = true;
-                        break;
-                    }
-                }
-
-                // Player distance from king
-                float kingCenterX = kingPig.GetX() + kingPig.GetWidth() * 0.5f;
-                float kingCenterY = kingPig.GetY() + kingPig.GetHeight() * 0.5f;
-                float playerCenterX = player.GetX() + player.GetWidth() * 0.5f;
-                float playerCenterY = player.GetY() + player.GetHeight() * 0.5f;
-
-                float dxKing = playerCenterX - kingCenterX;
-                float dyKing = playerCenterY - kingCenterY;
-                float distSqKing = dxKing * dxKing + dyKing * dyKing;
-
-                if (!kingPigAwake)
-                {
-                    if (anyMinionDead ||
-                        distSqKing <= kingPigWakeRadius * kingPigWakeRadius)
-                    {
-                        kingPigAwake = true;
-                    }
-                }
-
-                // Face toward the player
-                kingPig.SetFacingRight(playerCenterX > kingCenterX);
-
-                // King melee attack range
-                const float KING_ATTACK_RANGE = 50.0f;
-                const float KING_VERT_TOL = 18.0f;
-
-                float dxAttackK = playerCenterX - kingCenterX;
-                float dyAttackK = playerCenterY - kingCenterY;
-                float distSqAttackK = dxAttackK * dxAttackK + dyAttackK * dyAttackK;
-
-                if (kingPigAwake && !kingPig.IsDead() && !kingPig.IsStunned() && distSqAttackK <= KING_ATTACK_RANGE * KING_ATTACK_RANGE && std::abs(dyAttackK) <= KING_VERT_TOL &&
-                    !player.IsDead())
-                {
-                    kingPig.SetState(EnemyAnimState::Attack);
-                    player.ApplyDamage(1);
-                }
-                else if (kingPigAwake && !kingPig.IsDead() && !kingPig.IsStunned())
-                {
-                    // Chase the player
-                    if (distSqKing > 1.0f)
-                    {
-                        float len = std::sqrt(distSqKing);
-                        dxKing /= len;
-                        dyKing /= len;
-
-                        const float KING_SPEED = 95.0f;
-                        float kdx = dxKing * KING_SPEED * dt;
-                        float kdy = dyKing * KING_SPEED * dt;
-
-                        kingPig.SetState(EnemyAnimState::Run);
-                        kingPig.MoveWithCollision(kdx, kdy, levelDesigner);
-                    }
-                    else
-                    {
-                        kingPig.SetState(EnemyAnimState::Idle);
-                    }
-                }
-                else if (!kingPig.IsDead())
-                {
-                    kingPig.SetState(EnemyAnimState::Idle);
-                }
-            }
-            else
-            {
-                // Player not in Level 2 → keep pigs idle
-                for (Enemy& pig : minionPigs)
-                    pig.SetState(EnemyAnimState::Idle);
-                kingPig.SetState(EnemyAnimState::Idle);
-            }
-
-            // Player attack vs enemies 
-
-            if (levelDesigner.GetActiveLevel() == 1 && player.IsAttacking())
-            {
-                SDL_FRect hitBox = player.GetAttackHitBox();
-                unsigned int atkId = player.GetAttackNumber();
-
-                // Minions
-                for (Enemy& pig : minionPigs)
+                // Sim time controls: P = pause, -/= = slower/faster
+                // Profiler overlay: F3
+                if (e.type == SDL_KEYDOWN && !e.key.repeat)
                 {
-                    if (pig.IsDead())
-                        continue;
-
-                    SDL_FRect pigRect{
-                        pig.GetX(),
-                        pig.GetY(),
-                        static_cast<float>(pig.GetWidth()),
-                        static_cast<float>(pig.GetHeight())
-                    };
-
-                    if (RectsOverlap(hitBox, pigRect))
-                    {
-                        pig.ApplyDamage(1, atkId); // 3 HP total
-                    }
+                    if (e.key.keysym.sym == SDLK_p)
+                        sim.TogglePause();
+                    else if (e.key.keysym.sym == SDLK_MINUS)
+                        sim.ScaleTime(0.5);
+                    else if (e.key.keysym.sym == SDLK_EQUALS)
+                        sim.ScaleTime(2.0);
+                    else if (e.key.keysym.sym == SDLK_F3)
+                        profiler.ToggleOverlay();
                 }
 
-                // King
-                if (!kingPig.IsDead())
-                {
-                    SDL_FRect kingRect{
-                        kingPig.GetX(),
-                        kingPig.GetY(),
-                        static_cast<float>(kingPig.GetWidth()),
-                        static_cast<float>(kingPig.GetHeight())
-                    };
-
-                    if (RectsOverlap(hitBox, kingRect))
-                    {
-                        kingPig.ApplyDamage(1, atkId); // 5 HP total
-                    }
-                }
+                game.HandleEvent(e);
             }
-
-            // Update animation frames 
-            player.Update();
-            kingPig.Update();
-            for (Enemy& pig : minionPigs)
-                pig.Update();
         }
-        else
-        {
-            
-            //  TELEPORTING THROUGH DOOR (no control)
-            const Uint32 phaseDuration = 600; // ms per door phase
-            Uint32 elapsed = now - travelStartTime;
 
-            if (travelState == DoorTravelState::GoingIn)
-            {
-                if (elapsed >= phaseDuration && activeDoor)
-                {
-                    // Move to target level/position
-                    int newLevel = activeDoor->GetToLevel();
-                    playerLevelIndex = newLevel;
-                    levelDesigner.SetActiveLevel(newLevel);
-
-                    player.SetPosition(activeDoor->GetTargetX(),
-                        activeDoor->GetTargetY());
-                    player.SetState(AnimState::DoorOut);
-
-                    // Start King dialogue the first time we enter Level 2
-                    if (newLevel == 1 && !kingPigDialogueStarted)
-                    {
-                        kingPigDialogue.Start();
-                        kingPigDialogueStarted = true;
-                    }
-
-                    // Switch to the opposite door
-                    if (activeDoor == &doorLevel0To1)
-                        activeDoor = &doorLevel1To0;
-                    else
-                        activeDoor = &doorLevel0To1;
-
-                    activeDoor->SetState(DoorAnimState::Opening);
-
-                    travelState = DoorTravelState::ComingOut;
-                    travelStartTime = now;
-                }
-            }
-            else if (travelState == DoorTravelState::ComingOut)
-            {
-                if (elapsed >= phaseDuration)
-                {
-                    if (activeDoor)
-                        activeDoor->SetState(DoorAnimState::Closing);
+        // Keyboard state each frame
+        const Uint8* keystate = SDL_GetKeyboardState(nullptr);
+        PlayerInput held;
+        held.left = keystate[SDL_SCANCODE_A] || keystate[SDL_SCANCODE_LEFT];
+        held.right = keystate[SDL_SCANCODE_D] || keystate[SDL_SCANCODE_RIGHT];
+        held.up = keystate[SDL_SCANCODE_W] || keystate[SDL_SCANCODE_UP];
+        held.down = keystate[SDL_SCANCODE_S] || keystate[SDL_SCANCODE_DOWN];
+        held.door = keystate[SDL_SCANCODE_F] != 0;
+        sim.SetHeldKeys(held);
 
-                    player.SetState(AnimState::Idle);
-                    travelState = DoorTravelState::None;
-                    activeDoor = nullptr;
-                }
-            }
+        // Newest finished tick (keeps the previous one if none arrived)
+        sim.GetSnapshots().AcquireLatest(snapshot);
 
-            // Still update animations during teleport
-            player.Update();
-            kingPig.Update();
-            for (Enemy& pig : minionPigs)
-                pig.Update();
-            kingPigDialogue.Update();
-        }
+        // How far we are between the previous and current sim state
+        float alpha = snapshot.GetAlpha(SDL_GetPerformanceCounter());
 
         // RENDER 
 
-        SDL_SetRenderDrawColor(renderer, 30, 30, 30, 255);
-        SDL_RenderClear(renderer);
-
-        levelDesigner.Render(renderer);
+        game.Render(renderer, snapshot, alpha);
+        profiler.RenderOverlay(renderer);
 
-        if (levelDesigner.GetActiveLevel() == 0)
         {
-            doorLevel0To1.Render(renderer);
+            ScopedTimer timer(ProfilePhase::Present);
+            SDL_RenderPresent(renderer);
         }
-        else if (levelDesigner.GetActiveLevel() == 1)
-        {
-            doorLevel1To0.Render(renderer);
-
-            // Minion pigs
-            for (Enemy& pig : minionPigs)
-                pig.Render(renderer);
-
-            // King Pig
-            kingPig.Render(renderer);
 
-            // Dialogue bubbles over King
-            if (kingPigDialogue.IsPlaying())
-                kingPigDialogue.Render(renderer, kingPig.GetX(), kingPig.GetY());
-        }
+        profiler.EndFrame();
+    }
 
-        // Draw player only in the active level
-        if (levelDesigner.GetActiveLevel() == playerLevelIndex)
-            player.Render(renderer);
+    sim.Stop();
 
-        // UI:life bar 
-        int hearts = player.GetHealth();
-        hearts = std::max(0, std::min(hearts, player.GetMaxHealth()));
+    if (!options.profileCsvPath.empty())
+        profiler.WriteCsv(options.profileCsvPath);
 
-        if (hearts > 0)
-        {
-            SDL_Rect src;
-            src.x = 0;
-            src.y = 0;
-            src.w = HEART_W * hearts;
-            src.h = LIVE_BAR_H;
-
-            SDL_Rect dst;
-            dst.x = 16;
-            dst.y = 16;
-            dst.w = src.w * 2;
-            dst.h = src.h * 2;
-
-            SDL_RenderCopy(renderer, liveBarTex, &src, &dst);
-        }
-
-        SDL_RenderPresent(renderer);
-    }
     return 0;
 }
@@ -0,0 +1,302 @@
+#include "Profiler.h"
+#include "TextureManager.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+    const char* PHASE_NAMES[] =
+    {
+        "events",
+        "player_control",
+        "minion_ai",
+        "king_pig_ai",
+        "hit_pass",
+        "animation",
+        "level_render",
+        "entity_render",
+        "present"
+    };
+
+    // Overlay bar colors, same order as ProfilePhase
+    const SDL_Color PHASE_COLORS[] =
+    {
+        { 200, 200, 200, 255 },
+        {  80, 160, 255, 255 },
+        { 255, 140,  60, 255 },
+        { 255,  60,  60, 255 },
+        { 255, 220,  60, 255 },
+        { 160, 100, 255, 255 },
+        {  60, 200, 120, 255 },
+        {  60, 220, 220, 255 },
+        { 255, 100, 200, 255 }
+    };
+
+    // Overlay layout
+    const int PANEL_X = 1280 - 330;
+    const int PANEL_Y = 16;
+    const int PANEL_W = 314;
+    const int ROW_H = 20;
+    const int DIGIT_W = 6;
+    const int DIGIT_H = 8;
+    const int DIGIT_SCALE = 2;
+    const double MS_PER_PIXEL = 0.05;     // bar width scale
+    const int HIST_BARS = 60;             // 0.5 ms each, 0-30 ms
+    const double HIST_BAR_MS = 0.5;
+    const int HIST_HEIGHT = 48;
+
+    // Session histogram buckets
+    const double HIST_MIN_MS = 0.00001;
+    const double HIST_GROWTH = 1.02;
+}
+
+Profiler::Profiler()
+{
+    m_msPerCounter = 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+    m_histograms.assign(HIST_SERIES * HIST_BUCKETS, 0);
+}
+
+void Profiler::BeginFrame()
+{
+    // m_current is drained by EndFrame, so sim-thread samples taken
+    // between two frames are not lost
+    m_frameStart = SDL_GetPerformanceCounter();
+}
+
+void Profiler::AddSample(ProfilePhase phase, Uint64 counterTicks)
+{
+    m_current[static_cast<int>(phase)].fetch_add(counterTicks, std::memory_order_relaxed);
+}
+
+void Profiler::EndFrame()
+{
+    double frameMs = (SDL_GetPerformanceCounter() - m_frameStart) * m_msPerCounter;
+
+    for (int i = 0; i < PHASE_COUNT; ++i)
+    {
+        double ms = m_current[i].exchange(0, std::memory_order_relaxed) * m_msPerCounter;
+        m_phaseHistory[m_historyPos][i] = ms;
+        AddToHistogram(i, ms);
+    }
+
+    m_frameHistory[m_historyPos] = frameMs;
+    AddToHistogram(PHASE_COUNT, frameMs);
+
+    m_historyPos = (m_historyPos + 1) % HISTORY_FRAMES;
+    if (m_historyCount < HISTORY_FRAMES)
+        ++m_historyCount;
+
+    ++m_sessionFrames;
+}
+
+int Profiler::MsToBucket(double ms)
+{
+    if (ms <= HIST_MIN_MS)
+        return 0;
+
+    int bucket = static_cast<int>(std::log(ms / HIST_MIN_MS) / std::log(HIST_GROWTH));
+    return std::min(bucket, HIST_BUCKETS - 1);
+}
+
+double Profiler::BucketToMs(int bucket)
+{
+    // geometric middle of the bucket
+    return HIST_MIN_MS * std::pow(HIST_GROWTH, bucket + 0.5);
+}
+
+void Profiler::AddToHistogram(int series, double ms)
+{
+    ++m_histograms[series * HIST_BUCKETS + MsToBucket(ms)];
+
+    m_sessionTotalMs[series] += ms;
+    m_sessionMaxMs[series] = std::max(m_sessionMaxMs[series], ms);
+}
+
+double Profiler::HistogramPercentile(int series, double percentile) const
+{
+    if (m_sessionFrames == 0)
+        return 0.0;
+
+    Uint64 target = static_cast<Uint64>(percentile / 100.0 * (m_sessionFrames - 1));
+    Uint64 seen = 0;
+
+    const Uint32* hist = &m_histograms[series * HIST_BUCKETS];
+    for (int b = 0; b < HIST_BUCKETS; ++b)
+    {
+        seen += hist[b];
+        if (seen > target)
+            return BucketToMs(b);
+    }
+    return BucketToMs(HIST_BUCKETS - 1);
+}
+
+double Profiler::GetAverageMs(ProfilePhase phase) const
+{
+    if (m_historyCount == 0)
+        return 0.0;
+
+    double sum = 0.0;
+    for (int f = 0; f < m_historyCount; ++f)
+        sum += m_phaseHistory[f][static_cast<int>(phase)];
+    return sum / m_historyCount;
+}
+
+double Profiler::GetAverageFrameMs() const
+{
+    if (m_historyCount == 0)
+        return 0.0;
+
+    double sum = 0.0;
+    for (int f = 0; f < m_historyCount; ++f)
+        sum += m_frameHistory[f];
+    return sum / m_historyCount;
+}
+
+double Profiler::GetFramePercentileMs(double percentile) const
+{
+    if (m_historyCount == 0)
+        return 0.0;
+
+    double sorted[HISTORY_FRAMES];
+    std::copy(m_frameHistory, m_frameHistory + m_historyCount, sorted);
+    std::sort(sorted, sorted + m_historyCount);
+
+    int index = static_cast<int>(percentile / 100.0 * (m_historyCount - 1) + 0.5);
+    return sorted[index];
+}
+
+bool Profiler::InitOverlay(SDL_Renderer* renderer)
+{
+    m_digits = TextureManager::Instance().LoadTexture("assets/anim/Live and Coins/Numbers (6x8).png", renderer);
+    return m_digits != nullptr;
+}
+
+void Profiler::DrawNumber(SDL_Renderer* renderer, double ms, int x, int y) const
+{
+    char text[16];
+    std::snprintf(text, sizeof(text), "%.2f", ms);
+
+    for (const char* c = text; *c; ++c)
+    {
+        if (*c == '.')
+        {
+            SDL_Rect dot{ x, y + (DIGIT_H - 2) * DIGIT_SCALE, 2 * DIGIT_SCALE - 1, 2 * DIGIT_SCALE - 1 };
+            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+            SDL_RenderFillRect(renderer, &dot);
+            x += 3 * DIGIT_SCALE;
+            continue;
+        }
+
+        int digit = *c - '0';
+        if (digit < 0 || digit > 9)
+            continue;
+
+        TextureManager::Instance().DrawFrame(m_digits.get(), renderer,
+            digit * DIGIT_W, 0, DIGIT_W, DIGIT_H,
+            x, y, DIGIT_SCALE);
+        x += (DIGIT_W + 1) * DIGIT_SCALE;
+    }
+}
+
+void Profiler::RenderOverlay(SDL_Renderer* renderer)
+{
+    if (!m_overlayEnabled || !renderer)
+        return;
+
+    const int rows = PHASE_COUNT + 2; // phases + frame avg + percentiles
+    SDL_Rect panel{ PANEL_X, PANEL_Y, PANEL_W, rows * ROW_H + HIST_HEIGHT + 12 };
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+    SDL_RenderFillRect(renderer, &panel);
+
+    int y = PANEL_Y + 4;
+    const int barX = PANEL_X + 90;
+    const int barMaxW = PANEL_W - 96;
+
+    // One row per phase: average ms + bar
+    for (int i = 0; i < PHASE_COUNT; ++i)
+    {
+        double avg = GetAverageMs(static_cast<ProfilePhase>(i));
+        DrawNumber(renderer, avg, PANEL_X + 4, y);
+
+        const SDL_Color& c = PHASE_COLORS[i];
+        SDL_Rect bar{ barX, y + 2, std::min(barMaxW, std::max(1, static_cast<int>(avg / MS_PER_PIXEL))), ROW_H - 8 };
+        SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, 255);
+        SDL_RenderFillRect(renderer, &bar);
+
+        y += ROW_H;
+    }
+
+    // Whole frame: average, then p50 / p95 / p99 over the rolling window
+    double frameAvg = GetAverageFrameMs();
+    DrawNumber(renderer, frameAvg, PANEL_X + 4, y);
+    SDL_Rect frameBar{ barX, y + 2, std::min(barMaxW, std::max(1, static_cast<int>(frameAvg / MS_PER_PIXEL))), ROW_H - 8 };
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderFillRect(renderer, &frameBar);
+    y += ROW_H;
+
+    DrawNumber(renderer, GetFramePercentileMs(50.0), PANEL_X + 4, y);
+    DrawNumber(renderer, GetFramePercentileMs(95.0), PANEL_X + 108, y);
+    DrawNumber(renderer, GetFramePercentileMs(99.0), PANEL_X + 212, y);
+    y += ROW_H + 4;
+
+    // Histogram of recent frame times (0.5 ms buckets, 0-30 ms)
+    int counts[HIST_BARS] = {};
+    int maxCount = 1;
+    for (int f = 0; f < m_historyCount; ++f)
+    {
+        int b = std::min(HIST_BARS - 1, static_cast<int>(m_frameHistory[f] / HIST_BAR_MS));
+        maxCount = std::max(maxCount, ++counts[b]);
+    }
+
+    const int barW = (PANEL_W - 8) / HIST_BARS;
+    for (int b = 0; b < HIST_BARS; ++b)
+    {
+        int h = counts[b] * HIST_HEIGHT / maxCount;
+        if (h == 0)
+            continue;
+
+        // green under 60 fps budget, red above
+        if ((b + 1) * HIST_BAR_MS <= 1000.0 / 60.0)
+            SDL_SetRenderDrawColor(renderer, 80, 220, 80, 255);
+        else
+            SDL_SetRenderDrawColor(renderer, 230, 70, 70, 255);
+
+        SDL_Rect bar{ PANEL_X + 4 + b * barW, y + HIST_HEIGHT - h, barW - 1, h };
+        SDL_RenderFillRect(renderer, &bar);
+    }
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
+
+bool Profiler::WriteCsv(const std::string& path) const
+{
+    std::ofstream out(path);
+    if (!out)
+    {
+        SDL_Log("Profiler: failed to open %s for writing", path.c_str());
+        return false;
+    }
+
+    out << "phase,frames,avg_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+
+    for (int s = 0; s < HIST_SERIES; ++s)
+    {
+        const char* name = (s < PHASE_COUNT) ? PHASE_NAMES[s] : "frame";
+        double avg = m_sessionFrames ? m_sessionTotalMs[s] / m_sessionFrames : 0.0;
+
+        out << name << ',' << m_sessionFrames << ','
+            << avg << ','
+            << HistogramPercentile(s, 50.0) << ','
+            << HistogramPercentile(s, 95.0) << ','
+            << HistogramPercentile(s, 99.0) << ','
+            << m_sessionMaxMs[s] << '\n';
+    }
+
+    SDL_Log("Profiler: wrote %s (%llu frames)", path.c_str(),
+        static_cast<unsigned long long>(m_sessionFrames));
+    return true;
+}
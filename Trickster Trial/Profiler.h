@@ -0,0 +1,116 @@
+#pragma once
+
+#include <SDL.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "TextureManager.h"
+
+// Main phases of a frame we time
+enum class ProfilePhase
+{
+    Events,
+    PlayerControl,
+    MinionAI,
+    KingPigAI,
+    HitPass,
+    Animation,
+    LevelRender,
+    EntityRender,
+    Present,
+    Count
+};
+
+// Frame profiler: per-phase scoped timers, rolling averages,
+// p50/p95/p99 frame times, an on-screen overlay and a CSV dump.
+//
+// Overlay (F3): one colored bar per phase (same order as ProfilePhase,
+// width = rolling average, 1 px = 0.05 ms) with its average in ms,
+// then the frame time p50/p95/p99 and a histogram of recent frames.
+class Profiler
+{
+public:
+    static Profiler& Instance()
+    {
+        static Profiler instance;
+        return instance;
+    }
+
+    // Frame boundaries (one game loop iteration / one headless tick)
+    void BeginFrame();
+    void EndFrame();
+
+    // Add time to a phase in the current frame (phases can run many
+    // times per frame, e.g. several sim ticks). Safe from any thread;
+    // sim-thread samples count toward the frame they land in.
+    void AddSample(ProfilePhase phase, Uint64 counterTicks);
+
+    // Rolling values over the last HISTORY_FRAMES frames (ms)
+    double GetAverageMs(ProfilePhase phase) const;
+    double GetAverageFrameMs() const;
+    double GetFramePercentileMs(double percentile) const;
+
+    // Overlay
+    bool InitOverlay(SDL_Renderer* renderer);
+    void RenderOverlay(SDL_Renderer* renderer);
+    void ToggleOverlay() { m_overlayEnabled = !m_overlayEnabled; }
+
+    // Whole-session summary (avg, p50, p95, p99, max per phase + frame)
+    bool WriteCsv(const std::string& path) const;
+
+private:
+    Profiler();
+
+    static const int PHASE_COUNT = static_cast<int>(ProfilePhase::Count);
+    static const int HISTORY_FRAMES = 240;
+
+    // Whole-session histograms: log buckets, each 2% wider than the
+    // last, from 10 ns up to ~1 s (fine for both ticks and frames)
+    static const int HIST_BUCKETS = 940;
+    static const int HIST_SERIES = PHASE_COUNT + 1; // phases + frame
+
+    static int    MsToBucket(double ms);
+    static double BucketToMs(int bucket);
+    void   AddToHistogram(int series, double ms);
+    double HistogramPercentile(int series, double percentile) const;
+
+    void DrawNumber(SDL_Renderer* renderer, double ms, int x, int y) const;
+
+    double m_msPerCounter = 0.0;
+    Uint64 m_frameStart = 0;
+
+    // Time spent per phase in the running frame (sim + render threads)
+    std::atomic<Uint64> m_current[PHASE_COUNT]{};
+
+    // Rolling history (ms), ring buffer
+    double m_phaseHistory[HISTORY_FRAMES][PHASE_COUNT]{};
+    double m_frameHistory[HISTORY_FRAMES]{};
+    int    m_historyPos = 0;
+    int    m_historyCount = 0;
+
+    // Session totals
+    std::vector<Uint32> m_histograms; // HIST_SERIES * HIST_BUCKETS
+    double m_sessionTotalMs[HIST_SERIES]{};
+    double m_sessionMaxMs[HIST_SERIES]{};
+    Uint64 m_sessionFrames = 0;
+
+    bool         m_overlayEnabled = false;
+    TextureHandle m_digits; // "Numbers (6x8).png", 0-9
+};
+
+// Adds the time spent in this scope to a phase
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(ProfilePhase phase)
+        : m_phase(phase), m_start(SDL_GetPerformanceCounter()) {}
+
+    ~ScopedTimer()
+    {
+        Profiler::Instance().AddSample(m_phase, SDL_GetPerformanceCounter() - m_start);
+    }
+
+private:
+    ProfilePhase m_phase;
+    Uint64       m_start;
+};
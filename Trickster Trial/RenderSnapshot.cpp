@@ -0,0 +1,35 @@
+#include "RenderSnapshot.h"
+#include <utility>
+
+float RenderSnapshot::GetAlpha(Uint64 nowCounter) const
+{
+    double alpha = publishAlpha;
+
+    if (!paused && nowCounter > publishCounter && stepSeconds > 0.0)
+    {
+        double elapsed = static_cast<double>(nowCounter - publishCounter) /
+            static_cast<double>(SDL_GetPerformanceFrequency());
+        alpha += elapsed * timeScale / stepSeconds;
+    }
+
+    // Never extrapolate past the newest tick
+    return alpha > 1.0 ? 1.0f : static_cast<float>(alpha);
+}
+
+void SnapshotExchange::Publish(RenderSnapshot& snapshot)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::swap(m_pending, snapshot);
+    m_hasNew = true;
+}
+
+bool SnapshotExchange::AcquireLatest(RenderSnapshot& snapshot)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_hasNew)
+        return false;
+
+    std::swap(m_pending, snapshot);
+    m_hasNew = false;
+    return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <SDL.h>
+#include <mutex>
+#include "LevelDesigner.h"
+#include "SpriteBatch.h"
+
+// Everything the render thread draws for one sim tick: the level shown
+// then, the sorted sprite list (player, pigs, doors, dialogue bubble,
+// hearts) with each sprite's previous and current position, plus what's
+// needed to interpolate between them.
+struct RenderSnapshot
+{
+    SpriteBatch sprites;
+
+    // Active level at that tick, drawn without the level lock
+    LevelDesigner::LevelRef level;
+    int worldWidth = 0, worldHeight = 0;   // pixels
+
+    Uint64 tick = 0;             // sim tick it was taken after
+
+    // Camera target (player center) at the previous and latest tick
+    float focusPrevX = 0.0f, focusPrevY = 0.0f;
+    float focusX = 0.0f, focusY = 0.0f;
+
+    // Interpolation: sub-tick progress at publish time, advanced by
+    // real time (scaled) until the next snapshot arrives
+    Uint64 publishCounter = 0;   // SDL_GetPerformanceCounter() at publish
+    double publishAlpha = 0.0;
+    double stepSeconds = 1.0 / 120.0;
+    double timeScale = 1.0;
+    bool   paused = false;
+
+    float GetAlpha(Uint64 nowCounter) const;
+};
+
+// Latest-value handoff between the sim thread and the render thread.
+// Publish() swaps the finished snapshot in (the caller gets an old
+// buffer back to refill); AcquireLatest() swaps the newest one out.
+// Neither side ever waits for the other to finish a frame.
+class SnapshotExchange
+{
+public:
+    void Publish(RenderSnapshot& snapshot);
+
+    // false = nothing newer than what the caller already has
+    bool AcquireLatest(RenderSnapshot& snapshot);
+
+private:
+    std::mutex     m_mutex;
+    RenderSnapshot m_pending;
+    bool           m_hasNew = false;
+};
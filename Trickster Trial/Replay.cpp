@@ -0,0 +1,105 @@
+#include "Replay.h"
+#include "ByteIO.h"
+
+namespace
+{
+    const char   REPLAY_MAGIC[4] = { 'T', 'T', 'R', 'P' };
+    const Uint16 REPLAY_VERSION = 1;
+    const int    MAX_ATTACKS_PER_TICK = 7; // 3 bits
+}
+
+bool ReplayWriter::Open(const std::string& path, double stepSeconds)
+{
+    m_out.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_out)
+    {
+        SDL_Log("Replay: failed to open %s for writing", path.c_str());
+        return false;
+    }
+
+    Uint8 header[16];
+    std::memcpy(header, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    WriteU16(header + 4, REPLAY_VERSION);
+    WriteU16(header + 6, 0);
+    WriteU32(header + 8, static_cast<Uint32>(stepSeconds * 1000000.0 + 0.5));
+    WriteU32(header + 12, 0);
+    m_out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    return true;
+}
+
+void ReplayWriter::WriteTick(const PlayerInput& input, Uint32 stateHash)
+{
+    if (!m_out.is_open())
+        return;
+
+    int attacks = input.attackPresses;
+    if (attacks > MAX_ATTACKS_PER_TICK)
+        attacks = MAX_ATTACKS_PER_TICK;
+
+    Uint8 bits = 0;
+    if (input.left)  bits |= 1 << 0;
+    if (input.right) bits |= 1 << 1;
+    if (input.up)    bits |= 1 << 2;
+    if (input.down)  bits |= 1 << 3;
+    if (input.door)  bits |= 1 << 4;
+    bits |= static_cast<Uint8>(attacks << 5);
+
+    Uint8 record[5];
+    record[0] = bits;
+    WriteU32(record + 1, stateHash);
+    m_out.write(reinterpret_cast<const char*>(record), sizeof(record));
+}
+
+void ReplayWriter::Close()
+{
+    if (m_out.is_open())
+        m_out.close();
+}
+
+bool ReplayReader::Open(const std::string& path)
+{
+    m_in.open(path, std::ios::binary);
+    if (!m_in)
+    {
+        SDL_Log("Replay: failed to open %s", path.c_str());
+        return false;
+    }
+
+    Uint8 header[16];
+    if (!m_in.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        SDL_memcmp(header, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0)
+    {
+        SDL_Log("Replay: %s is not a replay file", path.c_str());
+        return false;
+    }
+
+    Uint16 version = ReadU16(header + 4);
+    if (version != REPLAY_VERSION)
+    {
+        SDL_Log("Replay: %s has unsupported version %u", path.c_str(), version);
+        return false;
+    }
+
+    m_stepSeconds = ReadU32(header + 8) / 1000000.0;
+    return true;
+}
+
+bool ReplayReader::ReadTick(PlayerInput& outInput, Uint32& outStateHash)
+{
+    Uint8 record[5];
+    if (!m_in.read(reinterpret_cast<char*>(record), sizeof(record)))
+        return false;
+
+    Uint8 bits = record[0];
+    outInput = PlayerInput();
+    outInput.left = (bits & (1 << 0)) != 0;
+    outInput.right = (bits & (1 << 1)) != 0;
+    outInput.up = (bits & (1 << 2)) != 0;
+    outInput.down = (bits & (1 << 3)) != 0;
+    outInput.door = (bits & (1 << 4)) != 0;
+    outInput.attackPresses = bits >> 5;
+
+    outStateHash = ReadU32(record + 1);
+    return true;
+}
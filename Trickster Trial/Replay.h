@@ -0,0 +1,42 @@
+#pragma once
+
+#include <SDL.h>
+#include <fstream>
+#include <string>
+
+#include "Game.h"
+
+// Binary input recording for deterministic replays.
+//
+// File layout (little endian):
+//   header: "TTRP", u16 version, u16 reserved, u32 tick length (us), u32 reserved
+//   per tick: u8 input bits, u32 world state hash after that tick
+//
+// Input bits: 0 left, 1 right, 2 up, 3 down, 4 door (F), 5-7 attack clicks (0..7)
+class ReplayWriter
+{
+public:
+    bool Open(const std::string& path, double stepSeconds);
+    void WriteTick(const PlayerInput& input, Uint32 stateHash);
+    void Close();
+
+    bool IsOpen() const { return m_out.is_open(); }
+
+private:
+    std::ofstream m_out;
+};
+
+class ReplayReader
+{
+public:
+    bool Open(const std::string& path);
+
+    // false at end of stream
+    bool ReadTick(PlayerInput& outInput, Uint32& outStateHash);
+
+    double GetStepSeconds() const { return m_stepSeconds; }
+
+private:
+    std::ifstream m_in;
+    double        m_stepSeconds = 0.0;
+};
@@ -0,0 +1,164 @@
+#include "SimulationThread.h"
+#include "Replay.h"
+#include <algorithm>
+
+namespace
+{
+    // Never simulate more than this much real time at once (spiral of death)
+    const double MAX_FRAME_TIME = 0.25;
+
+    // Nor more ticks per pass: at 16x time scale 0.25 s is 480 ticks, and
+    // a snapshot only goes out between passes
+    const int MAX_STEPS_PER_PASS = 30;
+}
+
+SimulationThread::SimulationThread(Game& game, ReplayWriter* recorder)
+    : m_game(game), m_recorder(recorder)
+{
+}
+
+SimulationThread::~SimulationThread()
+{
+    Stop();
+}
+
+bool SimulationThread::Start()
+{
+    if (m_running)
+        return true;
+
+    m_running = true;
+    m_thread = std::thread(&SimulationThread::Run, this);
+    return true;
+}
+
+void SimulationThread::Stop()
+{
+    m_running = false;
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void SimulationThread::SetHeldKeys(const PlayerInput& held)
+{
+    std::lock_guard<std::mutex> lock(m_inputMutex);
+    m_input.left = held.left;
+    m_input.right = held.right;
+    m_input.up = held.up;
+    m_input.down = held.down;
+    m_input.door = held.door;
+}
+
+void SimulationThread::AddAttackPress()
+{
+    std::lock_guard<std::mutex> lock(m_inputMutex);
+    ++m_input.attackPresses;
+}
+
+void SimulationThread::TogglePause()
+{
+    std::lock_guard<std::mutex> lock(m_inputMutex);
+    m_pauseRequested = !m_pauseRequested;
+}
+
+void SimulationThread::ScaleTime(double factor)
+{
+    std::lock_guard<std::mutex> lock(m_inputMutex);
+    m_timeScaleFactor *= factor;
+}
+
+void SimulationThread::PublishSnapshot(RenderSnapshot& snapshot)
+{
+    const GameClock& clock = m_game.GetClock();
+
+    m_game.BuildSnapshot(snapshot);
+    snapshot.tick = clock.GetTickCount();
+    snapshot.publishCounter = SDL_GetPerformanceCounter();
+    snapshot.publishAlpha = clock.GetAlpha();
+    snapshot.stepSeconds = clock.GetStepSeconds();
+    snapshot.timeScale = clock.GetTimeScale();
+    snapshot.paused = clock.IsPaused();
+
+    m_snapshots.Publish(snapshot);
+}
+
+void SimulationThread::Run()
+{
+    GameClock& clock = m_game.GetClock();
+    const Uint64 counterFreq = SDL_GetPerformanceFrequency();
+    Uint64 lastCounter = SDL_GetPerformanceCounter();
+
+    RenderSnapshot snapshot;
+    PublishSnapshot(snapshot); // something to draw before the first tick
+
+    while (m_running)
+    {
+        // Real time since the last pass (high resolution, clamped)
+        Uint64 counter = SDL_GetPerformanceCounter();
+        double frameTime = static_cast<double>(counter - lastCounter) / static_cast<double>(counterFreq);
+        lastCounter = counter;
+
+        if (frameTime > MAX_FRAME_TIME)
+            frameTime = MAX_FRAME_TIME;
+
+        // Take the input and time controls handed over since last pass
+        PlayerInput input;
+        bool controlsChanged = false;
+        {
+            std::lock_guard<std::mutex> lock(m_inputMutex);
+            input = m_input;
+
+            if (m_pauseRequested)
+            {
+                clock.SetPaused(!clock.IsPaused());
+                m_pauseRequested = false;
+                controlsChanged = true;
+            }
+
+            if (m_timeScaleFactor != 1.0)
+            {
+                clock.SetTimeScale(clock.GetTimeScale() * m_timeScaleFactor);
+                m_timeScaleFactor = 1.0;
+                controlsChanged = true;
+            }
+        }
+
+        // Pause/time scale are applied by the clock
+        clock.AddRealTime(frameTime);
+
+        // Run as many fixed ticks as the elapsed time covers
+        int consumedPresses = input.attackPresses;
+        bool ticked = false;
+        int steps = 0;
+
+        while (steps < MAX_STEPS_PER_PASS && clock.ConsumeStep())
+        {
+            m_game.Tick(input);
+
+            if (m_recorder && m_recorder->IsOpen())
+                m_recorder->WriteTick(input, m_game.HashState());
+
+            input.attackPresses = 0; // clicks only count once
+            ticked = true;
+            ++steps;
+        }
+
+        // Behind by more than a pass: slow down instead of falling further back
+        if (steps == MAX_STEPS_PER_PASS)
+            clock.DiscardBacklog();
+
+        if (ticked)
+        {
+            std::lock_guard<std::mutex> lock(m_inputMutex);
+            m_input.attackPresses -= consumedPresses;
+        }
+
+        if (ticked || controlsChanged)
+            PublishSnapshot(snapshot);
+
+        // Sleep until the next tick is due (at least 1 ms, so we never spin)
+        double untilNextTick = clock.IsPaused() ? 0.005 :
+            (1.0 - clock.GetAlpha()) * clock.GetStepSeconds() / clock.GetTimeScale();
+        SDL_Delay(static_cast<Uint32>(std::max(1.0, untilNextTick * 1000.0)));
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <SDL.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "Game.h"
+#include "RenderSnapshot.h"
+
+class ReplayWriter;
+
+// Runs the fixed-step simulation on its own thread. The main thread
+// keeps events + rendering: it hands input over here and draws the
+// latest RenderSnapshot, so a slow frame never delays a tick.
+class SimulationThread
+{
+public:
+    // recorder may be nullptr (not recording)
+    SimulationThread(Game& game, ReplayWriter* recorder);
+    ~SimulationThread();
+
+    bool Start();
+    void Stop();
+
+    // Main thread -> sim. Held keys replace the previous state; attack
+    // presses add up until a tick consumes them.
+    void SetHeldKeys(const PlayerInput& held);
+    void AddAttackPress();
+
+    // Sim time controls (P, -, =)
+    void TogglePause();
+    void ScaleTime(double factor);
+
+    SnapshotExchange& GetSnapshots() { return m_snapshots; }
+
+private:
+    void Run();
+    void PublishSnapshot(RenderSnapshot& snapshot);
+
+    Game&         m_game;
+    ReplayWriter* m_recorder = nullptr;
+
+    std::thread       m_thread;
+    std::atomic<bool> m_running{ false };
+
+    // Shared with the main thread
+    std::mutex  m_inputMutex;
+    PlayerInput m_input;
+    bool        m_pauseRequested = false;
+    double      m_timeScaleFactor = 1.0; // pending multiplier
+
+    SnapshotExchange m_snapshots;
+};
@@ -0,0 +1,125 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+
+void SpriteBatch::Begin()
+{
+    m_commands.clear();
+}
+
+void SpriteBatch::Draw(SDL_Texture* texture, const SDL_Rect& src, const SDL_FRect& dst,
+    SDL_RendererFlip flip, SpriteLayer layer, float sortY)
+{
+    Draw(texture, src, dst, dst, flip, layer, sortY);
+}
+
+void SpriteBatch::Draw(SDL_Texture* texture, const SDL_Rect& src, const SDL_FRect& prevDst, const SDL_FRect& dst,
+    SDL_RendererFlip flip, SpriteLayer layer, float sortY)
+{
+    if (!texture)
+        return;
+
+    DrawCommand cmd;
+    cmd.texture = texture;
+    cmd.src = src;
+    cmd.prevDst = prevDst;
+    cmd.dst = dst;
+    cmd.flip = flip;
+    cmd.layer = layer;
+    cmd.sortY = sortY;
+    cmd.sequence = static_cast<unsigned int>(m_commands.size());
+    m_commands.push_back(cmd);
+}
+
+void SpriteBatch::Sort()
+{
+    std::sort(m_commands.begin(), m_commands.end(), [](const DrawCommand& a, const DrawCommand& b)
+        {
+            if (a.layer != b.layer)
+                return a.layer < b.layer;
+            if (a.sortY != b.sortY)
+                return a.sortY < b.sortY;
+            if (a.texture != b.texture)
+                return a.texture < b.texture;
+            return a.sequence < b.sequence;
+        });
+}
+
+void SpriteBatch::Flush(SDL_Renderer* renderer, float alpha, const SDL_Rect& view, SpriteLayer firstLayer, SpriteLayer lastLayer)
+{
+    m_lastSpriteCount = 0;
+    m_lastSubmitCount = 0;
+
+    SDL_Texture* runTexture = nullptr;
+    int texW = 1, texH = 1;
+
+    m_vertices.clear();
+    m_indices.clear();
+
+    for (const DrawCommand& cmd : m_commands)
+    {
+        if (cmd.layer < firstLayer || cmd.layer > lastLayer)
+            continue;
+
+        // Whole pixels keep the pixel art crisp while moving
+        float x0 = static_cast<float>(static_cast<int>(cmd.prevDst.x + (cmd.dst.x - cmd.prevDst.x) * alpha) - view.x);
+        float y0 = static_cast<float>(static_cast<int>(cmd.prevDst.y + (cmd.dst.y - cmd.prevDst.y) * alpha) - view.y);
+        float x1 = x0 + cmd.dst.w;
+        float y1 = y0 + cmd.dst.h;
+
+        // Off screen
+        if (x1 <= 0.0f || y1 <= 0.0f || x0 >= view.w || y0 >= view.h)
+            continue;
+
+        ++m_lastSpriteCount;
+
+        // Texture switch ends the current run
+        if (cmd.texture != runTexture)
+        {
+            Submit(renderer, runTexture);
+
+            runTexture = cmd.texture;
+            SDL_QueryTexture(runTexture, nullptr, nullptr, &texW, &texH);
+            if (texW <= 0 || texH <= 0)
+                texW = texH = 1;
+        }
+
+        float u0 = static_cast<float>(cmd.src.x) / texW;
+        float v0 = static_cast<float>(cmd.src.y) / texH;
+        float u1 = static_cast<float>(cmd.src.x + cmd.src.w) / texW;
+        float v1 = static_cast<float>(cmd.src.y + cmd.src.h) / texH;
+
+        // Flips are just swapped texture coordinates
+        if (cmd.flip & SDL_FLIP_HORIZONTAL)
+            std::swap(u0, u1);
+        if (cmd.flip & SDL_FLIP_VERTICAL)
+            std::swap(v0, v1);
+
+        const SDL_Color white{ 255, 255, 255, 255 };
+        int base = static_cast<int>(m_vertices.size());
+
+        m_vertices.push_back(SDL_Vertex{ SDL_FPoint{ x0, y0 }, white, SDL_FPoint{ u0, v0 } });
+        m_vertices.push_back(SDL_Vertex{ SDL_FPoint{ x1, y0 }, white, SDL_FPoint{ u1, v0 } });
+        m_vertices.push_back(SDL_Vertex{ SDL_FPoint{ x1, y1 }, white, SDL_FPoint{ u1, v1 } });
+        m_vertices.push_back(SDL_Vertex{ SDL_FPoint{ x0, y1 }, white, SDL_FPoint{ u0, v1 } });
+
+        const int quad[6] = { 0, 1, 2, 0, 2, 3 };
+        for (int i : quad)
+            m_indices.push_back(base + i);
+    }
+
+    Submit(renderer, runTexture);
+}
+
+void SpriteBatch::Submit(SDL_Renderer* renderer, SDL_Texture* texture)
+{
+    if (texture && !m_indices.empty())
+    {
+        SDL_RenderGeometry(renderer, texture,
+            m_vertices.data(), static_cast<int>(m_vertices.size()),
+            m_indices.data(), static_cast<int>(m_indices.size()));
+        ++m_lastSubmitCount;
+    }
+
+    m_vertices.clear();
+    m_indices.clear();
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <SDL.h>
+#include <vector>
+
+// Draw order buckets; inside a bucket sprites are sorted by sortY
+// (bottom edge), so lower sprites overlap higher ones
+enum class SpriteLayer
+{
+    Props,      // doors
+    Characters, // player + pigs
+    Effects,    // dialogue bubbles
+    UI,
+    Count
+};
+
+// One queued sprite. dst is where it is at the latest sim tick,
+// prevDst where it was one tick earlier (blended by alpha when drawn).
+struct DrawCommand
+{
+    SDL_Texture*     texture = nullptr;
+    SDL_Rect         src{ 0, 0, 0, 0 };
+    SDL_FRect        prevDst{ 0.0f, 0.0f, 0.0f, 0.0f };
+    SDL_FRect        dst{ 0.0f, 0.0f, 0.0f, 0.0f };
+    SDL_RendererFlip flip = SDL_FLIP_NONE;
+    SpriteLayer      layer = SpriteLayer::Characters;
+    float            sortY = 0.0f;
+    unsigned int     sequence = 0; // submission order, keeps ties stable
+};
+
+// Collects the sprite draws of a sim tick, sorts them (layer, sortY,
+// texture) and submits each run that shares a texture as one
+// SDL_RenderGeometry call. Filled on the sim thread, flushed (possibly
+// several times) on the render thread.
+class SpriteBatch
+{
+public:
+    void Begin();
+
+    // Static sprite
+    void Draw(SDL_Texture* texture, const SDL_Rect& src, const SDL_FRect& dst,
+        SDL_RendererFlip flip, SpriteLayer layer, float sortY);
+
+    // Moving sprite, interpolated from prevDst to dst
+    void Draw(SDL_Texture* texture, const SDL_Rect& src, const SDL_FRect& prevDst, const SDL_FRect& dst,
+        SDL_RendererFlip flip, SpriteLayer layer, float sortY);
+
+    // Sort everything queued since Begin() into draw order
+    void Sort();
+
+    // Submit the (sorted) sprites of layers firstLayer..lastLayer that
+    // overlap 'view' (world space), drawn relative to its top-left.
+    // Positions are blended by alpha and snapped to whole pixels.
+    void Flush(SDL_Renderer* renderer, float alpha, const SDL_Rect& view,
+        SpriteLayer firstLayer = SpriteLayer::Props, SpriteLayer lastLayer = SpriteLayer::UI);
+
+    // Sprites drawn (after culling) / SDL_RenderGeometry calls of the last Flush
+    int GetLastSpriteCount() const { return m_lastSpriteCount; }
+    int GetLastSubmitCount() const { return m_lastSubmitCount; }
+
+private:
+    void Submit(SDL_Renderer* renderer, SDL_Texture* texture);
+
+    std::vector<DrawCommand> m_commands;
+
+    // Reused between flushes
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int>        m_indices;
+
+    int m_lastSpriteCount = 0;
+    int m_lastSubmitCount = 0;
+};
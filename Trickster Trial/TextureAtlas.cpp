@@ -0,0 +1,464 @@
+#include "TextureAtlas.h"
+#include "TextureManager.h"
+#include "AssetArchive.h"
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    const int MAX_PAGE_SIZE = 2048;
+    const int PADDING = 1; // transparent gutter so neighbours never bleed in
+}
+
+const int TextureAtlas::COMMON_GROUP;
+
+TextureAtlas::TextureAtlas()
+{
+    EnsureGroup(COMMON_GROUP).wanted = true;
+}
+
+TextureAtlas::Group& TextureAtlas::EnsureGroup(int group)
+{
+    if (group >= static_cast<int>(m_groups.size()))
+        m_groups.resize(group + 1);
+    return m_groups[group];
+}
+
+int TextureAtlas::AddSheet(const std::string& filePath, int& outW, int& outH, int group)
+{
+    if (group < 0)
+        group = COMMON_GROUP;
+
+    auto found = m_idsByPath.find(filePath);
+    if (found != m_idsByPath.end())
+    {
+        Sprite& sprite = m_sprites[found->second];
+        outW = sprite.w;
+        outH = sprite.h;
+
+        // Used by more than one level: keep it resident
+        if (sprite.group != group && sprite.group != COMMON_GROUP)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            sprite.group = COMMON_GROUP;
+            sprite.page = -1;
+            m_groups[COMMON_GROUP].dirty = true;
+        }
+
+        return found->second;
+    }
+
+    outW = 0;
+    outH = 0;
+    if (!TextureManager::Instance().QueryImageSize(filePath, outW, outH))
+        return -1;
+
+    Sprite sprite;
+    sprite.path = filePath;
+    sprite.w = outW;
+    sprite.h = outH;
+    sprite.group = group;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    int id = static_cast<int>(m_sprites.size());
+    m_sprites.push_back(sprite);
+    m_idsByPath[filePath] = id;
+    EnsureGroup(group).dirty = true;
+
+    return id;
+}
+
+bool TextureAtlas::Pack(int group, int pageSize, std::vector<int>& outPageHeights)
+{
+    outPageHeights.clear();
+
+    // Tallest first keeps shelves tight
+    std::vector<int> order;
+    for (size_t i = 0; i < m_sprites.size(); ++i)
+    {
+        if (m_sprites[i].group == group)
+            order.push_back(static_cast<int>(i));
+    }
+
+    std::sort(order.begin(), order.end(), [&](int a, int b)
+        {
+            if (m_sprites[a].h != m_sprites[b].h)
+                return m_sprites[a].h > m_sprites[b].h;
+            return m_sprites[a].w > m_sprites[b].w;
+        });
+
+    int page = -1;
+    int shelfX = 0, shelfY = 0, shelfH = 0;
+
+    for (int id : order)
+    {
+        Sprite& sprite = m_sprites[id];
+        int w = sprite.w + PADDING;
+        int h = sprite.h + PADDING;
+
+        if (w > pageSize || h > pageSize)
+        {
+            std::cout << "Sheet too big for atlas page: " << sprite.path << "\n";
+            return false;
+        }
+
+        // New shelf when this row is full
+        if (page >= 0 && shelfX + w > pageSize)
+        {
+            shelfY += shelfH;
+            shelfX = 0;
+            shelfH = 0;
+        }
+
+        // New page when the shelves run out
+        if (page < 0 || shelfY + h > pageSize)
+        {
+            ++page;
+            outPageHeights.push_back(0);
+            shelfX = 0;
+            shelfY = 0;
+            shelfH = 0;
+        }
+
+        sprite.packedPage = page;
+        sprite.packedRect = SDL_Rect{ shelfX, shelfY, sprite.w, sprite.h };
+
+        shelfX += w;
+        shelfH = std::max(shelfH, h);
+        outPageHeights[page] = std::max(outPageHeights[page], shelfY + sprite.h);
+    }
+
+    return true;
+}
+
+bool TextureAtlas::Build(SDL_Renderer* renderer)
+{
+    return BeginBuild(renderer) && FinishBuild(renderer);
+}
+
+bool TextureAtlas::BeginBuild(SDL_Renderer* renderer)
+{
+    // Headless: regions stay empty, sizes are already known
+    if (!renderer || m_building)
+        return true;
+
+    m_buildGroups.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < m_groups.size(); ++i)
+        {
+            const Group& group = m_groups[i];
+            if (group.wanted && (!group.built || group.dirty))
+                m_buildGroups.push_back(static_cast<int>(i));
+        }
+    }
+
+    if (m_buildGroups.empty())
+        return true;
+
+    m_pageSize = MAX_PAGE_SIZE;
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) == 0 && info.max_texture_width > 0)
+        m_pageSize = std::min({ m_pageSize, info.max_texture_width, info.max_texture_height });
+
+    std::vector<int> packedGroups;
+    for (int group : m_buildGroups)
+    {
+        if (Pack(group, m_pageSize, m_groups[group].packedPageHeights))
+            packedGroups.push_back(group);
+        else
+            DropFailedGroup(group);
+    }
+
+    m_buildGroups.swap(packedGroups);
+    if (m_buildGroups.empty())
+        return false;
+
+    // Packed sheets are already decoded; the rest is the slow part of
+    // loading, spread over the cores
+    std::vector<std::string> paths;
+    for (Sprite& sprite : m_sprites)
+    {
+        if (std::find(m_buildGroups.begin(), m_buildGroups.end(), sprite.group) == m_buildGroups.end())
+            continue;
+
+        const AssetArchive::Entry* packed = AssetArchive::Instance().Find(sprite.path);
+        if (packed && packed->kind == AssetArchive::EntryKind::Image &&
+            packed->width == sprite.w && packed->height == sprite.h)
+        {
+            sprite.loaderSlot = -1;
+        }
+        else
+        {
+            sprite.loaderSlot = static_cast<int>(paths.size());
+            paths.push_back(sprite.path);
+        }
+    }
+
+    m_building = m_loader.Start(paths);
+    return m_building;
+}
+
+float TextureAtlas::GetBuildProgress() const
+{
+    return m_building ? m_loader.GetProgress() : 1.0f;
+}
+
+bool TextureAtlas::FinishBuild(SDL_Renderer* renderer)
+{
+    if (!renderer || !m_building)
+        return true;
+
+    m_building = false;
+
+    const int pageSize = m_pageSize;
+    bool ok = true;
+    int sheetCount = 0;
+    int pageCount = 0;
+
+    for (int groupIndex : m_buildGroups)
+    {
+        Group& group = m_groups[groupIndex];
+
+        std::vector<SDL_Surface*> surfaces;
+        std::vector<SDL_Texture*> pages;
+
+        for (int pageHeight : group.packedPageHeights)
+        {
+            SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, pageSize, pageHeight, 32, SDL_PIXELFORMAT_RGBA32);
+            if (!surface)
+            {
+                SDL_Log("Failed to create atlas page: %s", SDL_GetError());
+                ok = false;
+                break;
+            }
+            surfaces.push_back(surface);
+        }
+
+        // Copy every decoded sheet (alpha included) into place
+        for (size_t i = 0; ok && i < m_sprites.size(); ++i)
+        {
+            Sprite& sprite = m_sprites[i];
+            if (sprite.group != groupIndex)
+                continue;
+
+            SDL_Surface* image = nullptr;
+            if (sprite.loaderSlot < 0)
+            {
+                // Wraps the mapped pixels, no copy
+                const AssetArchive::Entry* packed = AssetArchive::Instance().Find(sprite.path);
+                image = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<Uint8*>(packed->data),
+                    packed->width, packed->height, 32, packed->pitch, SDL_PIXELFORMAT_RGBA32);
+            }
+            else
+            {
+                image = m_loader.TakeSurface(sprite.loaderSlot);
+            }
+
+            if (!image)
+            {
+                ok = false; // already logged by the loader
+                break;
+            }
+
+            SDL_SetSurfaceBlendMode(image, SDL_BLENDMODE_NONE);
+            SDL_Rect dst = sprite.packedRect;
+            SDL_BlitSurface(image, nullptr, surfaces[sprite.packedPage], &dst);
+            SDL_FreeSurface(image);
+            ++sheetCount;
+        }
+
+        for (SDL_Surface* surface : surfaces)
+        {
+            if (ok)
+            {
+                SDL_Texture* page = SDL_CreateTextureFromSurface(renderer, surface);
+                if (page)
+                {
+                    SDL_SetTextureBlendMode(page, SDL_BLENDMODE_BLEND);
+                    pages.push_back(page);
+                }
+                else
+                {
+                    SDL_Log("Failed to upload atlas page: %s", SDL_GetError());
+                    ok = false;
+                }
+            }
+            SDL_FreeSurface(surface);
+        }
+
+        if (!ok)
+        {
+            for (SDL_Texture* page : pages)
+                SDL_DestroyTexture(page);
+            DropFailedGroup(groupIndex);
+            break;
+        }
+
+        // Swap the new pages in. Old pages only exist when sheets were
+        // added to a group that was already built (during Init).
+        std::vector<SDL_Texture*> oldPages;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            oldPages.swap(group.pages);
+            group.pages = pages;
+            group.built = true;
+            group.dirty = false;
+
+            for (Sprite& sprite : m_sprites)
+            {
+                if (sprite.group != groupIndex)
+                    continue;
+
+                sprite.page = sprite.packedPage;
+                sprite.rect = sprite.packedRect;
+            }
+        }
+
+        for (SDL_Texture* page : oldPages)
+            SDL_DestroyTexture(page);
+
+        pageCount += static_cast<int>(pages.size());
+    }
+
+    m_loader.Reset();
+    m_buildGroups.clear();
+
+    if (!ok)
+        return false;
+
+    if (sheetCount > 0)
+        std::cout << "Packed " << sheetCount << " sheets into "
+            << pageCount << " atlas page(s) of " << pageSize << " px\n";
+
+    return true;
+}
+
+void TextureAtlas::SetWantedGroups(const std::vector<int>& groups, Uint64 releaseTick)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Groups are only created by AddSheet() (main thread), so this never
+    // resizes m_groups under a build; unknown groups have nothing to load
+    for (size_t i = 0; i < m_groups.size(); ++i)
+    {
+        Group& group = m_groups[i];
+
+        bool wanted = i == COMMON_GROUP ||
+            std::find(groups.begin(), groups.end(), static_cast<int>(i)) != groups.end();
+
+        if (group.wanted && !wanted)
+            group.releaseTick = releaseTick;
+
+        group.wanted = wanted;
+    }
+}
+
+void TextureAtlas::UpdateResidency(SDL_Renderer* renderer, Uint64 drawnTick)
+{
+    if (!renderer)
+        return;
+
+    // Upload whatever finished decoding, then start on anything new.
+    // After a failure the failing group is no longer wanted; the others
+    // are picked up again next frame.
+    bool failed = m_building && m_loader.IsDone() && !FinishBuild(renderer);
+
+    if (!m_building && !failed)
+        BeginBuild(renderer);
+
+    // Release groups no longer wanted once no drawn snapshot needs them
+    std::vector<SDL_Texture*> released;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (size_t i = 0; i < m_groups.size(); ++i)
+        {
+            Group& group = m_groups[i];
+            if (group.wanted || !group.built || drawnTick < group.releaseTick)
+                continue;
+
+            released.insert(released.end(), group.pages.begin(), group.pages.end());
+            group.pages.clear();
+            group.built = false;
+
+            for (Sprite& sprite : m_sprites)
+            {
+                if (sprite.group == static_cast<int>(i))
+                    sprite.page = -1;
+            }
+        }
+    }
+
+    for (SDL_Texture* page : released)
+        SDL_DestroyTexture(page);
+}
+
+void TextureAtlas::DropFailedGroup(int group)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_groups[group].wanted = false;
+
+    SDL_Log("TextureAtlas: group %d failed to load, not retrying until it is requested again", group);
+}
+
+AtlasRegion TextureAtlas::GetRegion(int spriteId) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    AtlasRegion region;
+    if (spriteId < 0 || spriteId >= static_cast<int>(m_sprites.size()))
+        return region;
+
+    const Sprite& sprite = m_sprites[spriteId];
+    const Group& group = m_groups[sprite.group];
+    if (!group.wanted || sprite.page < 0 || sprite.page >= static_cast<int>(group.pages.size()))
+        return region;
+
+    region.texture = group.pages[sprite.page];
+    region.rect = sprite.rect;
+    return region;
+}
+
+int TextureAtlas::GetPageCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    int count = 0;
+    for (const Group& group : m_groups)
+        count += static_cast<int>(group.pages.size());
+    return count;
+}
+
+bool TextureAtlas::IsGroupResident(int group) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return group >= 0 && group < static_cast<int>(m_groups.size()) && m_groups[group].built;
+}
+
+void TextureAtlas::Clear()
+{
+    // Drop a background decode that was never finished
+    if (m_building)
+    {
+        m_loader.Reset();
+        m_building = false;
+        m_buildGroups.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (Group& group : m_groups)
+    {
+        for (SDL_Texture* page : group.pages)
+            SDL_DestroyTexture(page);
+        group.pages.clear();
+        group.built = false;
+    }
+
+    // Sprite ids stay valid; a later Build() re-uploads everything wanted
+    for (Sprite& sprite : m_sprites)
+        sprite.page = -1;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <SDL.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "AssetLoader.h"
+
+// Where a packed sheet ended up: atlas page + sub-rectangle
+struct AtlasRegion
+{
+    SDL_Texture* texture = nullptr;
+    SDL_Rect     rect{ 0, 0, 0, 0 };
+};
+
+// Packs every animation sheet into one (or a few) big textures so
+// consecutive sprite draws don't switch textures.
+//   1. AddSheet() during Init (only reads the PNG header, works headless)
+//   2. Build() once all sheets are known (decodes, packs, uploads), or
+//      BeginBuild() / FinishBuild() to decode in the background while
+//      a loading screen polls GetBuildProgress()
+//   3. GetRegion() when drawing
+//
+// Sheets belong to a residency group (COMMON_GROUP or one per level).
+// Each group gets its own pages, so a level's sheets are uploaded when
+// it's wanted and released again when it isn't: GPU memory follows the
+// current level instead of the whole game.
+class TextureAtlas
+{
+public:
+    static TextureAtlas& Instance()
+    {
+        static TextureAtlas instance;
+        return instance;
+    }
+
+    // Always resident (player, doors, UI)
+    static const int COMMON_GROUP = 0;
+
+    // Group for content that only appears in one level
+    static int LevelGroup(int levelIndex) { return levelIndex + 1; }
+
+    // Register a sheet and get its sprite id (-1 on failure).
+    // The same path always returns the same id; a sheet registered by
+    // two different groups moves to COMMON_GROUP.
+    int AddSheet(const std::string& filePath, int& outW, int& outH, int group = COMMON_GROUP);
+
+    // Pack and upload all wanted groups. Sheets added after a Build()
+    // are picked up by calling Build() again.
+    bool Build(SDL_Renderer* renderer);
+
+    // Build() in two steps: pack + start decoding on worker threads,
+    // then (main thread) wait, copy into pages and upload
+    bool BeginBuild(SDL_Renderer* renderer);
+    bool FinishBuild(SDL_Renderer* renderer);
+
+    // 0..1 while sheets decode; 1 when there's nothing to wait for
+    float GetBuildProgress() const;
+    bool  IsBuildReady() const { return !m_building || m_loader.IsDone(); }
+
+    // Groups that should be resident (COMMON_GROUP always is). Any
+    // thread. GetRegion() stops handing out dropped groups right away,
+    // but their pages stay on the GPU until a snapshot of sim tick
+    // 'releaseTick' or later is drawn, since older snapshots may still
+    // point at them.
+    void SetWantedGroups(const std::vector<int>& groups, Uint64 releaseTick);
+
+    // Render thread, once per frame: uploads wanted groups (decoded in
+    // the background) and releases unwanted ones. drawnTick = sim tick
+    // of the snapshot about to be drawn.
+    void UpdateResidency(SDL_Renderer* renderer, Uint64 drawnTick);
+
+    // Empty region if the id is unknown or its group isn't wanted and
+    // resident (headless: always empty). Safe from any thread.
+    AtlasRegion GetRegion(int spriteId) const;
+
+    int  GetPageCount() const;
+    bool IsGroupResident(int group) const;
+
+    // Destroy the page textures (must happen before the renderer goes away)
+    void Clear();
+
+private:
+    TextureAtlas();
+
+    struct Sprite
+    {
+        std::string path;
+        int         w = 0;
+        int         h = 0;
+        int         group = COMMON_GROUP;
+        int         page = -1;             // index into the group's pages, -1 = not resident
+        SDL_Rect    rect{ 0, 0, 0, 0 };
+        int         packedPage = -1;       // page/rect of the build in progress
+        SDL_Rect    packedRect{ 0, 0, 0, 0 };
+        int         loaderSlot = -1;       // index in m_loader, -1 = pixels come from the AssetArchive
+    };
+
+    struct Group
+    {
+        bool   wanted = false;
+        bool   built = false;              // pages uploaded (possibly zero pages)
+        bool   dirty = false;              // sheets added since it was built
+        Uint64 releaseTick = 0;            // see SetWantedGroups()
+        std::vector<SDL_Texture*> pages;
+        std::vector<int>          packedPageHeights;
+    };
+
+    Group& EnsureGroup(int group);
+
+    // A group that failed to pack or upload stops being wanted, so it
+    // isn't retried every frame; the next SetWantedGroups() that asks
+    // for it again gives it another try
+    void DropFailedGroup(int group);
+
+    // Shelf packing of one group into pages of pageSize x pageSize;
+    // fills Sprite::packedPage/packedRect
+    bool Pack(int group, int pageSize, std::vector<int>& outPageHeights);
+
+    std::vector<Sprite>        m_sprites;
+    std::map<std::string, int> m_idsByPath;
+    std::vector<Group>         m_groups;
+
+    // Guards what the sim thread reads (sprite page/rect, group pages)
+    // and the wanted flags it writes
+    mutable std::mutex m_mutex;
+
+    // Between BeginBuild() and FinishBuild()
+    AssetLoader      m_loader;
+    bool             m_building = false;
+    int              m_pageSize = 0;
+    std::vector<int> m_buildGroups;
+};
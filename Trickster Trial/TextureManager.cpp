@@ -1,14 +1,107 @@
 #include "TextureManager.h"
+#include "AssetArchive.h"
 #include <SDL_image.h>
 
-SDL_Texture* TextureManager::LoadTexture(const std::string& filePath, SDL_Renderer* renderer)
+TextureHandle TextureManager::LoadTexture(const std::string& filePath, SDL_Renderer* renderer)
 {
-    SDL_Texture* tex = IMG_LoadTexture(renderer, filePath.c_str());
+    auto it = m_cache.find(filePath);
+    if (it != m_cache.end() && it->second.renderer == renderer)
+    {
+        if (TextureHandle cached = it->second.texture.lock())
+            return cached;
+    }
+
+    // Packed images are already decoded: straight to the GPU
+    SDL_Texture* tex = nullptr;
+    const AssetArchive::Entry* packed = AssetArchive::Instance().Find(filePath);
+
+    if (packed && packed->kind == AssetArchive::EntryKind::Image)
+    {
+        tex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, packed->width, packed->height);
+        if (tex)
+        {
+            SDL_UpdateTexture(tex, nullptr, packed->data, packed->pitch);
+            SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+        }
+    }
+    else
+    {
+        tex = IMG_LoadTexture(renderer, filePath.c_str());
+    }
+
     if (!tex)
     {
         SDL_Log("Failed to load texture %s: %s", filePath.c_str(), IMG_GetError());
+        return nullptr;
+    }
+
+    TextureHandle handle(tex, SDL_DestroyTexture);
+
+    PurgeExpired();
+    CacheEntry& entry = m_cache[filePath];
+    entry.texture = handle;
+    entry.renderer = renderer;
+
+    return handle;
+}
+
+int TextureManager::GetCachedTextureCount()
+{
+    PurgeExpired();
+    return static_cast<int>(m_cache.size());
+}
+
+void TextureManager::PurgeExpired()
+{
+    for (auto it = m_cache.begin(); it != m_cache.end();)
+    {
+        if (it->second.texture.expired())
+            it = m_cache.erase(it);
+        else
+            ++it;
     }
-    return tex;
+}
+
+bool TextureManager::QueryImageSize(const std::string& filePath, int& outW, int& outH)
+{
+    const AssetArchive::Entry* packed = AssetArchive::Instance().Find(filePath);
+    if (packed && packed->kind == AssetArchive::EntryKind::Image)
+    {
+        outW = packed->width;
+        outH = packed->height;
+        return true;
+    }
+
+    SDL_RWops* file = SDL_RWFromFile(filePath.c_str(), "rb");
+    if (!file)
+    {
+        SDL_Log("Failed to open image %s: %s", filePath.c_str(), SDL_GetError());
+        return false;
+    }
+
+    // 8-byte signature, then the IHDR chunk: length, "IHDR", width, height (big endian)
+    Uint8 header[24];
+    size_t got = SDL_RWread(file, header, 1, sizeof(header));
+    SDL_RWclose(file);
+
+    static const Uint8 PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    if (got != sizeof(header) ||
+        SDL_memcmp(header, PNG_SIGNATURE, sizeof(PNG_SIGNATURE)) != 0 ||
+        SDL_memcmp(header + 12, "IHDR", 4) != 0)
+    {
+        SDL_Log("Not a PNG image: %s", filePath.c_str());
+        return false;
+    }
+
+    auto readBE32 = [](const Uint8* p) -> int
+        {
+            return static_cast<int>((Uint32(p[0]) << 24) | (Uint32(p[1]) << 16) |
+                (Uint32(p[2]) << 8) | Uint32(p[3]));
+        };
+
+    outW = readBE32(header + 16);
+    outH = readBE32(header + 20);
+    return true;
 }
 
 void TextureManager::DrawFrame(SDL_Texture* texture,
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <SDL.h>
 
+// Shared texture; destroyed when the last handle goes away
+using TextureHandle = std::shared_ptr<SDL_Texture>;
+
 class TextureManager
 {
 public:
@@ -12,8 +17,16 @@ public:
         return instance;
     }
 
-    // Load an image 
-    SDL_Texture* LoadTexture(const std::string& filePath, SDL_Renderer* renderer);
+    // Load an image. Textures are cached by path: loading the same file
+    // again returns the live texture without decoding it twice.
+    TextureHandle LoadTexture(const std::string& filePath, SDL_Renderer* renderer);
+
+    // Textures currently alive in the cache
+    int GetCachedTextureCount();
+
+    // Read image size from the archive index or the PNG header,
+    // without decoding pixels
+    bool QueryImageSize(const std::string& filePath, int& outW, int& outH);
 
     // Draw an arbitrary frame (generic helper)
     void DrawFrame(SDL_Texture* texture,
@@ -39,4 +52,15 @@ public:
 
 private:
     TextureManager() = default;
+
+    struct CacheEntry
+    {
+        std::weak_ptr<SDL_Texture> texture;
+        SDL_Renderer*              renderer = nullptr; // textures belong to one renderer
+    };
+
+    // Weak entries: the cache never keeps a texture alive by itself
+    std::unordered_map<std::string, CacheEntry> m_cache;
+
+    void PurgeExpired();
 };
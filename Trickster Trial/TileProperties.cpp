@@ -0,0 +1,104 @@
+#include "TileProperties.h"
+#include "AssetArchive.h"
+#include <fstream>
+#include <sstream>
+
+const Uint8 TileProperties::SOLID;
+const Uint8 TileProperties::WALKABLE;
+const Uint8 TileProperties::HAZARD;
+const Uint8 TileProperties::ONE_WAY;
+
+TileProperties::TileProperties()
+{
+    SetDefaults();
+}
+
+void TileProperties::SetDefaults()
+{
+    // Terrain.png: 17x11 tiles, the wooden floor block (columns 0-8,
+    // rows 6-8) is walkable, everything else is wall
+    m_cols = 17;
+    m_rows = 11;
+    m_flags.assign(m_cols * m_rows, SOLID);
+
+    for (int y = 6; y <= 8; ++y)
+        for (int x = 0; x <= 8; ++x)
+            m_flags[y * m_cols + x] = WALKABLE;
+}
+
+bool TileProperties::LoadFromFile(const std::string& path)
+{
+    std::ifstream in(path);
+    if (in)
+        return LoadFromStream(in, path);
+
+    const AssetArchive::Entry* packed = AssetArchive::Instance().Find(path);
+    if (packed && packed->kind == AssetArchive::EntryKind::File)
+    {
+        std::istringstream packedIn(std::string(reinterpret_cast<const char*>(packed->data), packed->size));
+        return LoadFromStream(packedIn, path);
+    }
+
+    SDL_Log("TileProperties: no %s, using built-in table", path.c_str());
+    return false;
+}
+
+bool TileProperties::LoadFromStream(std::istream& in, const std::string& path)
+{
+    int cols = 0, rows = 0;
+    int row = 0;
+    std::vector<Uint8> flags;
+
+    std::string line;
+    while (row < rows || cols == 0)
+    {
+        if (!std::getline(in, line))
+            break;
+
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        if (line.empty() || line.compare(0, 2, "//") == 0)
+            continue;
+
+        // First real line is the size
+        if (cols == 0)
+        {
+            std::istringstream header(line);
+            if (!(header >> cols >> rows) || cols <= 0 || rows <= 0 || cols > 256 || rows > 256)
+            {
+                SDL_Log("TileProperties: bad header in %s", path.c_str());
+                return false;
+            }
+            flags.assign(cols * rows, SOLID);
+            continue;
+        }
+
+        for (int x = 0; x < cols && x < static_cast<int>(line.size()); ++x)
+        {
+            Uint8& tile = flags[row * cols + x];
+            switch (line[x])
+            {
+            case '#': tile = SOLID; break;
+            case '.': tile = WALKABLE; break;
+            case '^': tile = WALKABLE | HAZARD; break;
+            case '-': tile = ONE_WAY; break;
+            default:
+                SDL_Log("TileProperties: unknown tile '%c' in %s (row %d)", line[x], path.c_str(), row);
+                return false;
+            }
+        }
+        ++row;
+    }
+
+    if (cols == 0 || row < rows)
+    {
+        SDL_Log("TileProperties: %s ends early", path.c_str());
+        return false;
+    }
+
+    m_cols = cols;
+    m_rows = rows;
+    m_flags.swap(flags);
+    return true;
+}
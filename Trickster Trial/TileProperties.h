@@ -0,0 +1,47 @@
+#pragma once
+
+#include <SDL.h>
+#include <istream>
+#include <string>
+#include <vector>
+
+// What each tile of a tileset does, loaded from a text file next to the
+// sheet (assets/textures/Terrain.tiles). Collision only ever asks this
+// table when a cell changes; LevelDesigner keeps the result as a bitmask.
+class TileProperties
+{
+public:
+    // Flags per tile type
+    static const Uint8 SOLID = 1 << 0;     // blocks movement
+    static const Uint8 WALKABLE = 1 << 1;  // floor
+    static const Uint8 HAZARD = 1 << 2;    // floor that hurts
+    static const Uint8 ONE_WAY = 1 << 3;   // passable from one side only
+
+    TileProperties();
+
+    // File format: "cols rows", then one line per sheet row with one
+    // character per tile:  # solid   . floor   ^ hazard   - one-way
+    // Lines starting with "//" are comments. Loose file first, then the
+    // asset archive.
+    bool LoadFromFile(const std::string& path);
+
+    // Built-in table for Terrain.png (used when the file is missing)
+    void SetDefaults();
+
+    // Tiles outside the table are solid
+    Uint8 GetFlags(int tileX, int tileY) const
+    {
+        if (tileX < 0 || tileY < 0 || tileX >= m_cols || tileY >= m_rows)
+            return SOLID;
+        return m_flags[tileY * m_cols + tileX];
+    }
+
+    bool IsSolid(int tileX, int tileY) const { return (GetFlags(tileX, tileY) & SOLID) != 0; }
+
+private:
+    bool LoadFromStream(std::istream& in, const std::string& path);
+
+    int m_cols = 0;
+    int m_rows = 0;
+    std::vector<Uint8> m_flags; // m_rows * m_cols
+};